@@ -16,7 +16,10 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPop.hpp"
 #include "Probe/Assertion.h"
 
+#include <algorithm>
+#include <functional>
 #include <string>
+#include <thread>
 
 using namespace IGC;
 using namespace iOpenCL;
@@ -78,8 +81,35 @@ void ZEBinaryBuilder::createKernel(
     addKernelSymbols(textID, annotations);
     addKernelRelocations(textID, annotations);
 
-    // zeinfo kernels
-    zeInfoKernel& zeKernel = mZEInfoBuilder.createKernel(annotations.m_kernelName);
+    // zeinfo kernels and kernels_misc_info. Only create the entries here to
+    // fix their order, they are filled in finalizeKernels
+    PendingKernel pending;
+    pending.annotations = &annotations;
+    pending.layout = &layout;
+    pending.grfSize = grfSize;
+    pending.isProgramDebuggable = isProgramDebuggable;
+    mZEInfoBuilder.createKernel(annotations.m_kernelName);
+    pending.zeKernelIdx = mZEInfoBuilder.getZEInfoContainer().kernels.size() - 1;
+    pending.zeKernelMiscIdx = -1;
+    if (hasKernelMiscInfo(annotations)) {
+        mZEInfoBuilder.createKernelMiscInfo(annotations.m_kernelName);
+        pending.zeKernelMiscIdx =
+            mZEInfoBuilder.getZEInfoContainer().kernels_misc_info.size() - 1;
+    }
+    mPendingKernels.push_back(pending);
+
+    addGTPinInfo(annotations);
+    addFunctionAttrs(annotations);
+    for (auto &&[name, visa] : visaasm)
+        addKernelVISAAsm(name, visa);
+}
+
+void ZEBinaryBuilder::fillKernelInfo(const PendingKernel& kernel)
+{
+    const SOpenCLKernelInfo& annotations = *kernel.annotations;
+    zeInfoContainer& container = mZEInfoBuilder.getZEInfoContainer();
+
+    zeInfoKernel& zeKernel = container.kernels[kernel.zeKernelIdx];
     addKernelExecEnv(annotations, zeKernel);
     addUserAttributes(annotations, zeKernel);
     addKernelExperimentalProperties(annotations, zeKernel);
@@ -87,7 +117,7 @@ void ZEBinaryBuilder::createKernel(
         annotations.m_threadPayload.HasLocalIDy ||
         annotations.m_threadPayload.HasLocalIDz) {
         addLocalIds(annotations.m_executionEnvironment.CompiledSIMDSize,
-            grfSize,
+            kernel.grfSize,
             annotations.m_threadPayload.HasLocalIDx,
             annotations.m_threadPayload.HasLocalIDy,
             annotations.m_threadPayload.HasLocalIDz,
@@ -96,20 +126,52 @@ void ZEBinaryBuilder::createKernel(
     addPayloadArgsAndBTI(annotations, zeKernel);
     addInlineSamplers(annotations, zeKernel);
     addMemoryBuffer(annotations, zeKernel);
+    if (kernel.isProgramDebuggable)
+        addKernelDebugEnv(annotations, *kernel.layout, zeKernel);
 
-    // zeinfo kernels_misc_info
-    if (hasKernelMiscInfo(annotations)) {
-        zeInfoKernelMiscInfo& kernelMisc =
-            mZEInfoBuilder.createKernelMiscInfo(annotations.m_kernelName);
-        addKernelArgInfo(annotations, kernelMisc);
-    }
+    if (kernel.zeKernelMiscIdx != -1)
+        addKernelArgInfo(annotations,
+            container.kernels_misc_info[kernel.zeKernelMiscIdx]);
+}
 
-    addGTPinInfo(annotations);
-    addFunctionAttrs(annotations);
-    for (auto &&[name, visa] : visaasm)
-        addKernelVISAAsm(name, visa);
-    if (isProgramDebuggable)
-        addKernelDebugEnv(annotations, layout, zeKernel);
+void ZEBinaryBuilder::finalizeKernels()
+{
+    if (mPendingKernels.empty())
+        return;
+
+    // Regkeys are read here: worker threads have neither the regkey snapshot
+    // nor the shader hash of the compile, see RegKeySnapshotScope.
+    mDumpHasNonKernelArgLdSt = IGC_IS_FLAG_ENABLED(DumpHasNonKernelArgLdSt);
+    mHasMultiScratchSpaces = CPlatform(mPlatform).hasScratchSurface() &&
+        IGC_IS_FLAG_ENABLED(SeparateSpillPvtScratchSpace);
+
+    // Every kernel only writes its own pre-allocated entries, so no locking
+    // is needed. Few kernels are not worth the thread start-up cost.
+    const size_t minKernelsPerThread = 16;
+    size_t numThreads = IGC_GET_FLAG_VALUE(ZEBinaryBuilderThreads);
+    if (numThreads == 0)
+        numThreads = std::thread::hardware_concurrency();
+    numThreads = std::min(numThreads,
+        mPendingKernels.size() / minKernelsPerThread);
+
+    if (numThreads <= 1) {
+        for (const PendingKernel& kernel : mPendingKernels)
+            fillKernelInfo(kernel);
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(numThreads);
+        size_t chunk = (mPendingKernels.size() + numThreads - 1) / numThreads;
+        for (size_t begin = 0; begin < mPendingKernels.size(); begin += chunk) {
+            size_t end = std::min(begin + chunk, mPendingKernels.size());
+            workers.emplace_back([this, begin, end]() {
+                for (size_t i = begin; i < end; ++i)
+                    fillKernelInfo(mPendingKernels[i]);
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+    }
+    mPendingKernels.clear();
 }
 
 void ZEBinaryBuilder::addGlobalHostAccessInfo(const SOpenCLProgramInfo& annotations)
@@ -149,17 +211,17 @@ void ZEBinaryBuilder::addFunctionAttrs(const IGC::SOpenCLKernelInfo& annotations
     // get function attribute list from the current process SKernelProgram
     auto funcAttrs = [](int simdSize, const IGC::SKernelProgram& program) {
         if (simdSize == 8)
-            return program.simd8.m_funcAttrs;
+            return std::cref(program.simd8.m_funcAttrs);
         else if (simdSize == 16)
-            return program.simd16.m_funcAttrs;
+            return std::cref(program.simd16.m_funcAttrs);
         else if (simdSize == 32)
-            return program.simd32.m_funcAttrs;
+            return std::cref(program.simd32.m_funcAttrs);
         else
-            return program.simd1.m_funcAttrs;
+            return std::cref(program.simd1.m_funcAttrs);
     } (annotations.m_executionEnvironment.CompiledSIMDSize,
        annotations.m_kernelProgram);
 
-    for (auto& funcAttr : funcAttrs) {
+    for (auto& funcAttr : funcAttrs.get()) {
         if (!funcAttr.f_isKernel && funcAttr.f_isExternal) {
             zeInfoFunction& zeFunction = mZEInfoBuilder.createFunction(funcAttr.f_name);
             addFunctionExecEnv(annotations, funcAttr, zeFunction);
@@ -431,28 +493,28 @@ void ZEBinaryBuilder::addKernelSymbols(
     // get symbol list from the current process SKernelProgram
     auto symbols = [](int simdSize, const IGC::SKernelProgram& program) {
         if (simdSize == 8)
-            return program.simd8.m_symbols;
+            return std::cref(program.simd8.m_symbols);
         else if (simdSize == 16)
-            return program.simd16.m_symbols;
+            return std::cref(program.simd16.m_symbols);
         else if (simdSize == 32)
-            return program.simd32.m_symbols;
+            return std::cref(program.simd32.m_symbols);
         else
-            return program.simd1.m_symbols;
+            return std::cref(program.simd1.m_symbols);
     } (annotations.m_executionEnvironment.CompiledSIMDSize,
         annotations.m_kernelProgram);
 
     // add local symbols of this kernel binary
-    for (auto sym : symbols.local) {
+    for (const auto& sym : symbols.get().local) {
         IGC_ASSERT(sym.s_type != vISA::GenSymType::S_UNDEF);
         addSymbol(sym, llvm::ELF::STB_LOCAL, kernelSectId);
     }
 
     // add function symbols defined in kernel text
-    for (auto sym : symbols.function)
+    for (const auto& sym : symbols.get().function)
         addSymbol(sym, llvm::ELF::STB_GLOBAL, kernelSectId);
 
     // we do not support sampler symbols now
-    IGC_ASSERT(symbols.sampler.empty());
+    IGC_ASSERT(symbols.get().sampler.empty());
 }
 
 void ZEBinaryBuilder::addProgramRelocations(const IGC::SOpenCLProgramInfo& annotations)
@@ -477,27 +539,26 @@ void ZEBinaryBuilder::addKernelRelocations(
     // get relocation list from the current process SKernelProgram
     auto relocs = [](int simdSize, const IGC::SKernelProgram& program) {
         if (simdSize == 8)
-            return program.simd8.m_relocs;
+            return std::cref(program.simd8.m_relocs);
         else if (simdSize == 16)
-            return program.simd16.m_relocs;
+            return std::cref(program.simd16.m_relocs);
         else if (simdSize == 32)
-            return program.simd32.m_relocs;
+            return std::cref(program.simd32.m_relocs);
         else
-            return program.simd1.m_relocs;
+            return std::cref(program.simd1.m_relocs);
     } (annotations.m_executionEnvironment.CompiledSIMDSize, annotations.m_kernelProgram);
 
     // FIXME: For r_type, zebin::R_TYPE_ZEBIN should have the same enum value as visa::GenRelocType.
     // Take the value directly
-    if (!relocs.empty())
-        for (auto reloc : relocs)
-            mBuilder.addRelRelocation(reloc.r_offset, reloc.r_symbol, (zebin::R_TYPE_ZEBIN)reloc.r_type, targetId);
+    for (const auto& reloc : relocs.get())
+        mBuilder.addRelRelocation(reloc.r_offset, reloc.r_symbol, (zebin::R_TYPE_ZEBIN)reloc.r_type, targetId);
 }
 
 void ZEBinaryBuilder::addKernelExperimentalProperties(const SOpenCLKernelInfo& annotations,
     zeInfoKernel& zeinfoKernel)
 {
     // Write to zeinfoKernel only when the attribute is enabled
-    if (IGC_IS_FLAG_ENABLED(DumpHasNonKernelArgLdSt)) {
+    if (mDumpHasNonKernelArgLdSt) {
         ZEInfoBuilder::addExpPropertiesHasNonKernelArgLdSt(zeinfoKernel,
             annotations.m_hasNonKernelArgLoad,
             annotations.m_hasNonKernelArgStore,
@@ -524,7 +585,7 @@ void ZEBinaryBuilder::addKernelExecEnv(const SOpenCLKernelInfo& annotations,
     env.has_dpas = annotations.m_executionEnvironment.HasDPAS;
     env.has_fence_for_image_access = annotations.m_executionEnvironment.HasReadWriteImages;
     env.has_global_atomics = annotations.m_executionEnvironment.HasGlobalAtomics;
-    env.has_multi_scratch_spaces = CPlatform(mPlatform).hasScratchSurface() && IGC_IS_FLAG_ENABLED(SeparateSpillPvtScratchSpace);
+    env.has_multi_scratch_spaces = mHasMultiScratchSpaces;
     env.has_no_stateless_write = (annotations.m_executionEnvironment.StatelessWritesCount == 0);
     env.has_stack_calls = annotations.m_executionEnvironment.HasStackCalls;
     env.require_disable_eufusion = annotations.m_executionEnvironment.RequireDisableEUFusion;
@@ -881,6 +942,7 @@ void ZEBinaryBuilder::addElfSections(void* elfBin, size_t elfSize)
 
 void ZEBinaryBuilder::getBinaryObject(llvm::raw_pwrite_stream& os)
 {
+    finalizeKernels();
     if (!mZEInfoBuilder.empty())
         mBuilder.addSectionZEInfo(mZEInfoBuilder.getZEInfoContainer());
     mBuilder.finalize(os);
@@ -57,6 +57,8 @@ public:
     /// This function can be called several times for adding different kernel information
     /// into this ZEObject
     /// The given rawIsaBinary must be lived through the entire ZEBinaryBuilder life
+    /// The .ze_info kernel entry is filled later, in finalizeKernels, so the
+    /// given annotations and layout must be lived until getBinaryObject is called
     void createKernel(
         const char*  rawIsaBinary,
         unsigned int rawIsaBinarySize,
@@ -214,6 +216,16 @@ private:
     /// add visasm of the kernel
     void addKernelVISAAsm(const std::string& kernel, const std::string& visaasm);
 
+    /// fill .ze_info kernel entries of all kernels added by createKernel.
+    /// Kernels are independent of each other so their entries are prepared
+    /// in parallel. Entries are pre-allocated in createKernel order, so the
+    /// output is identical to a serial build.
+    void finalizeKernels();
+
+    /// fill the .ze_info kernel entry and kernel misc info of one kernel
+    struct PendingKernel;
+    void fillKernelInfo(const PendingKernel& kernel);
+
     /// add global_host_access_table section to .ze_info
     void addGlobalHostAccessInfo(const IGC::SOpenCLProgramInfo& annotations);
 
@@ -233,6 +245,23 @@ private:
     zebin::ZEELFObjectBuilder::SectionID mGlobalConstSectID = -1;
     zebin::ZEELFObjectBuilder::SectionID mConstStringSectID = -1;
     zebin::ZEELFObjectBuilder::SectionID mGlobalSectID = -1;
+
+    /// kernels whose .ze_info entries are not filled yet. The indices refer
+    /// to entries already created in mZEInfoBuilder's container
+    struct PendingKernel {
+        const IGC::SOpenCLKernelInfo* annotations;
+        const IGC::CBTILayout* layout;
+        uint32_t grfSize;
+        bool isProgramDebuggable;
+        size_t zeKernelIdx;
+        // index into kernels_misc_info, or -1 if the kernel has none
+        int64_t zeKernelMiscIdx;
+    };
+    std::vector<PendingKernel> mPendingKernels;
+    /// regkey dependent settings of the kernel entries, read in
+    /// finalizeKernels on the compiling thread
+    bool mDumpHasNonKernelArgLdSt = false;
+    bool mHasMultiScratchSpaces = false;
 };
 
 // a helper function to get ZE image type from a OCL image type
@@ -0,0 +1,75 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2023 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include <istream>
+#include <streambuf>
+#include <cstddef>
+
+namespace Util
+{
+
+// Read-only std::streambuf over a caller-owned buffer. Unlike std::stringbuf
+// it does not copy the data, so large inputs (e.g. SPIR-V modules) can be fed
+// to stream based readers directly. The buffer has to outlive the stream.
+class MemoryStreamBuf : public std::streambuf
+{
+public:
+    MemoryStreamBuf( const char* data, std::size_t size )
+    {
+        char* begin = const_cast<char*>( data );
+        setg( begin, begin, begin + size );
+    }
+
+protected:
+    pos_type seekoff( off_type off, std::ios_base::seekdir dir,
+        std::ios_base::openmode which = std::ios_base::in ) override
+    {
+        if( !( which & std::ios_base::in ) )
+            return pos_type( off_type( -1 ) );
+
+        off_type base = 0;
+        switch( dir )
+        {
+        case std::ios_base::beg: base = 0; break;
+        case std::ios_base::cur: base = gptr() - eback(); break;
+        case std::ios_base::end: base = egptr() - eback(); break;
+        default: return pos_type( off_type( -1 ) );
+        }
+
+        off_type pos = base + off;
+        if( pos < 0 || pos > egptr() - eback() )
+            return pos_type( off_type( -1 ) );
+
+        setg( eback(), eback() + pos, egptr() );
+        return pos_type( pos );
+    }
+
+    pos_type seekpos( pos_type pos,
+        std::ios_base::openmode which = std::ios_base::in ) override
+    {
+        return seekoff( off_type( pos ), std::ios_base::beg, which );
+    }
+};
+
+// std::istream reading from a caller-owned buffer without copying it.
+class MemoryInputStream : public std::istream
+{
+public:
+    MemoryInputStream( const char* data, std::size_t size )
+        : std::istream( nullptr ), m_buf( data, size )
+    {
+        rdbuf( &m_buf );
+    }
+
+private:
+    MemoryStreamBuf m_buf;
+};
+
+} // namespace Util
@@ -1494,6 +1494,8 @@ public:
           Context = NULL;
   }
 
+  void setLazyFunctionTranslation(bool Lazy) { LazyFunctions = Lazy; }
+
   Type *transType(SPIRVType *BT);
   GlobalValue::LinkageTypes transLinkageType(const SPIRVValue* V);
   /// Decode SPIR-V encoding of vector type hint execution mode.
@@ -1520,6 +1522,8 @@ public:
   std::vector<Value *> transValue(const std::vector<SPIRVValue *>&, Function *F,
       BasicBlock *, BoolAction Action = BoolAction::Promote);
   Function *transFunction(SPIRVFunction *F);
+  bool isFunctionTranslationRoot(SPIRVFunction *BF,
+      const std::unordered_set<std::string> &EntryPointNames);
   bool transFPContractMetadata();
   bool transKernelMetadata();
   bool transNonTemporalMetadata(Instruction* I);
@@ -1587,6 +1591,9 @@ private:
   GlobalVariable *m_NamedBarrierVar;
   GlobalVariable *m_named_barrier_id;
   DICompileUnit* compileUnit = nullptr;
+  // Translate only functions reachable from the roots selected by
+  // isFunctionTranslationRoot, see translate().
+  bool LazyFunctions = false;
 
   // These storages are used to prevent duplication of alias.scope/noalias
   // metadata
@@ -4270,6 +4277,20 @@ SPIRVToLLVM::transFunction(SPIRVFunction *BF) {
   return F;
 }
 
+bool
+SPIRVToLLVM::isFunctionTranslationRoot(SPIRVFunction *BF,
+    const std::unordered_set<std::string> &EntryPointNames) {
+  if (BM->isEntryPoint(ExecutionModelKernel, BF->getId()))
+    return true;
+  // Functions sharing a name with an entry point get merged into the kernel
+  // by transFunction, which depends on them being translated first.
+  if (EntryPointNames.count(BF->getName()))
+    return true;
+  if (BF->getLinkageType() != LinkageTypeInternal)
+    return true;
+  return BF->hasDecorate(DecorationReferencedIndirectlyINTEL);
+}
+
 Value *SPIRVToLLVM::transAsmINTEL(SPIRVAsmINTEL *BA, Function *F, BasicBlock *BB) {
   bool HasSideEffect = BA->hasDecorate(DecorationSideEffectsINTEL);
   return InlineAsm::get(
@@ -4542,8 +4563,22 @@ SPIRVToLLVM::translate() {
       transValue(BV, nullptr, nullptr, true, BoolAction::Noop);
   }
 
+  // transFunction translates callees and address-taken functions on first
+  // use, so starting from the roots is enough to reach every function that
+  // can execute. Unreachable internal functions are never materialized.
+  std::unordered_set<std::string> EntryPointNames;
+  if (LazyFunctions) {
+    for (unsigned I = 0, E = BM->getNumFunctions(); I != E; ++I) {
+      SPIRVFunction *BF = BM->getFunction(I);
+      if (BM->isEntryPoint(ExecutionModelKernel, BF->getId()))
+        EntryPointNames.insert(BF->getName());
+    }
+  }
+
   for (unsigned I = 0, E = BM->getNumFunctions(); I != E; ++I) {
-    transFunction(BM->getFunction(I));
+    SPIRVFunction *BF = BM->getFunction(I);
+    if (!LazyFunctions || isFunctionTranslationRoot(BF, EntryPointNames))
+      transFunction(BF);
   }
   for(auto& funcs : FuncMap)
   {
@@ -4757,6 +4792,9 @@ SPIRVToLLVM::transKernelMetadata()
     {
         SPIRVFunction *BF = BM->getFunction(I);
         Function *F = static_cast<Function *>(getTranslatedValue(BF));
+        // Unreachable functions are skipped in lazy translation mode.
+        if (!F && LazyFunctions)
+            continue;
         IGC_ASSERT_MESSAGE(F, "Invalid translated function");
 
         // __attribute__((annotate("some_user_annotation"))) are passed via
@@ -5171,7 +5209,8 @@ __attr_unused static void dumpSPIRVBC(const char* fname, const char* data, unsig
 
 bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
     std::string &ErrMsg,
-    std::unordered_map<uint32_t, uint64_t> *specConstants) {
+    std::unordered_map<uint32_t, uint64_t> *specConstants,
+    bool LazyFunctions) {
   std::unique_ptr<SPIRVModule> BM( SPIRVModule::createSPIRVModule() );
   BM->setSpecConstantMap(specConstants);
   IS >> *BM;
@@ -5180,6 +5219,7 @@ bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
     BM->resolveUnknownStructFields();
     M = new Module("", C);
     SPIRVToLLVM BTL(M, BM.get());
+    BTL.setLazyFunctionTranslation(LazyFunctions);
 
     if (!BTL.translate()) {
       BM->getError(ErrMsg);
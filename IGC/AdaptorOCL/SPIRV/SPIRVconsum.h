@@ -24,10 +24,13 @@ See LICENSE.TXT for details.
 
 namespace igc_spv{
 // Loads SPIRV from istream and translate to LLVM module.
+// If LazyFunctions is set, only the bodies of functions reachable from
+// kernels, exported or indirectly referenced functions are translated.
 // Returns true if succeeds.
 bool ReadSPIRV(llvm::LLVMContext &C, std::istream &IS, llvm::Module *&M,
     std::string &ErrMsg,
-    std::unordered_map<uint32_t, uint64_t> *specConstants);
+    std::unordered_map<uint32_t, uint64_t> *specConstants,
+    bool LazyFunctions = false);
 
 }
 #endif
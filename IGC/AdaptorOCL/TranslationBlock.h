@@ -30,6 +30,11 @@ SPDX-License-Identifier: MIT
     #endif
 #endif
 
+namespace LockStats
+{
+struct Entry;
+}
+
 namespace TC
 {
 static const uint32_t STB_VERSION = 1006UL;
@@ -43,10 +48,14 @@ class  CTranslationBlock;
 extern "C" TRANSLATION_BLOCK_API void TRANSLATION_BLOCK_CALLING_CONV Register(STB_RegisterArgs* pRegisterArgs);
 extern "C" TRANSLATION_BLOCK_API CTranslationBlock* TRANSLATION_BLOCK_CALLING_CONV Create(STB_CreateArgs* pCreateArgs);
 extern "C" TRANSLATION_BLOCK_API void TRANSLATION_BLOCK_CALLING_CONV Delete(CTranslationBlock* pBlock);
+// Copies the wait statistics of up to numEntries locks that serialize
+// concurrent compiles to pEntries. Returns the number of instrumented locks.
+extern "C" TRANSLATION_BLOCK_API uint32_t TRANSLATION_BLOCK_CALLING_CONV IGCGetLockStats(LockStats::Entry* pEntries, uint32_t numEntries);
 
 typedef void (TRANSLATION_BLOCK_CALLING_CONV *PFNREGISTER)(STB_RegisterArgs* pRegisterArgs);
 typedef CTranslationBlock* (TRANSLATION_BLOCK_CALLING_CONV *PFNCREATE)(STB_CreateArgs* pCreateArgs);
 typedef void (TRANSLATION_BLOCK_CALLING_CONV *PFNDELETE)(CTranslationBlock* pBlock);
+typedef uint32_t (TRANSLATION_BLOCK_CALLING_CONV *PFNIGCGETLOCKSTATS)(LockStats::Entry* pEntries, uint32_t numEntries);
 
 #undef TRANSLATION_BLOCK_CALLING_CONV
 
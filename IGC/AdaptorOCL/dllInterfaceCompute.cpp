@@ -20,6 +20,8 @@ SPDX-License-Identifier: MIT
 #include <fstream>
 #include <mutex>
 #include <numeric>
+#include <list>
+#include <algorithm>
 
 #include "AdaptorCommon/customApi.hpp"
 #include "AdaptorOCL/OCL/LoadBuffer.h"
@@ -37,6 +39,7 @@ SPDX-License-Identifier: MIT
 #include "common/secure_mem.h"
 #include "common/shaderOverride.hpp"
 #include "common/ModuleSplitter.h"
+#include "inc/common/lock_stats.h"
 
 #include "CLElfLib/ElfReader.h"
 
@@ -71,6 +74,7 @@ SPDX-License-Identifier: MIT
 #include <sstream>
 #include <iomanip>
 #include "Probe/Assertion.h"
+#include "AdaptorOCL/OCL/util/MemoryInputStream.h"
 #include "common/StringMacros.hpp"
 #include "VISALinkerDriver/VLD.hpp"
 #include "VISALinkerDriver/VLD_SPIRVSplitter.hpp"
@@ -137,6 +141,8 @@ SPDX-License-Identifier: MIT
 #include <llvm/Support/Format.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/xxhash.h>
+#include <llvm/ADT/Hashing.h>
 #include "common/LLVMWarningsPop.hpp"
 
 #include "IGC/Metrics/IGCMetric.h"
@@ -148,7 +154,7 @@ using namespace IGC;
 namespace TC
 {
 
-static std::mutex llvm_mutex;
+static LockStats::InstrumentedMutex llvm_mutex(LockStats::LockId::LLVMGlobals);
 
 extern bool ProcessElfInput(
     STB_TranslateInputArgs& InputArgs,
@@ -425,6 +431,128 @@ spv_result_t DisassembleSPIRV(
 #endif // defined(IGC_SPIRV_TOOLS_ENABLED)
 
 #if defined(IGC_SPIRV_ENABLED)
+// Keeps the bitcode of recent SPIR-V translations so that rebuilding the same
+// module with the same specialization constants (e.g. once per context or
+// device) skips the SPIR-V reader. Entries are keyed by two independent hashes
+// of the SPIR-V binary, by the specialization constant values and by the
+// reader settings, and are evicted in LRU order once SPIRVTranslationCacheSize
+// is exceeded.
+class SPIRVTranslationCache
+{
+public:
+    // Reader settings that change the translated module.
+    enum ReaderFlags : uint32_t
+    {
+        KhronosTranslator         = 1 << 0,
+        LazyFunctionTranslation   = 1 << 1,
+    };
+
+    struct Key
+    {
+        uint64_t spirvHash[2];
+        uint64_t spirvSize;
+        uint64_t specConstHash;
+        uint32_t readerFlags;
+
+        bool operator==(const Key& other) const
+        {
+            return spirvHash[0] == other.spirvHash[0] &&
+                spirvHash[1] == other.spirvHash[1] &&
+                spirvSize == other.spirvSize &&
+                specConstHash == other.specConstHash &&
+                readerFlags == other.readerFlags;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            return static_cast<size_t>(llvm::hash_combine(
+                key.spirvHash[0], key.spirvHash[1], key.spirvSize,
+                key.specConstHash, key.readerFlags));
+        }
+    };
+
+    static Key makeKey(
+        llvm::StringRef SPIRVBinary,
+        const std::unordered_map<uint32_t, uint64_t>& specConstants,
+        uint32_t readerFlags)
+    {
+        // The map is unordered, so sort before hashing.
+        std::vector<std::pair<uint32_t, uint64_t>> sorted(specConstants.begin(), specConstants.end());
+        std::sort(sorted.begin(), sorted.end());
+        llvm::hash_code specHash = llvm::hash_combine_range(sorted.begin(), sorted.end());
+
+        Key key;
+        key.spirvHash[0] = llvm::xxHash64(SPIRVBinary);
+        key.spirvHash[1] = static_cast<uint64_t>(llvm::hash_value(SPIRVBinary));
+        key.spirvSize = SPIRVBinary.size();
+        key.specConstHash = static_cast<uint64_t>(specHash);
+        key.readerFlags = readerFlags;
+        return key;
+    }
+
+    std::unique_ptr<llvm::Module> lookup(const Key& key, llvm::LLVMContext& Context)
+    {
+        std::string bitcode;
+        {
+            const std::lock_guard<LockStats::InstrumentedMutex> lock(m_mutex);
+            auto found = m_index.find(key);
+            if (found == m_index.end())
+                return nullptr;
+            auto it = found->second;
+            m_entries.splice(m_entries.begin(), m_entries, it);
+            bitcode = it->second;
+        }
+
+        auto M = llvm::parseBitcodeFile(
+            llvm::MemoryBufferRef(bitcode, "spirv-translation-cache"), Context);
+        if (!M)
+        {
+            llvm::consumeError(M.takeError());
+            return nullptr;
+        }
+        return std::move(*M);
+    }
+
+    void insert(const Key& key, const llvm::Module& M, unsigned capacity)
+    {
+        std::string bitcode;
+        llvm::raw_string_ostream OS(bitcode);
+        llvm::WriteBitcodeToFile(M, OS);
+        OS.flush();
+
+        const std::lock_guard<LockStats::InstrumentedMutex> lock(m_mutex);
+        // Another thread may have translated the same module meanwhile.
+        auto found = m_index.find(key);
+        if (found != m_index.end())
+        {
+            m_entries.splice(m_entries.begin(), m_entries, found->second);
+            return;
+        }
+        m_entries.emplace_front(key, std::move(bitcode));
+        m_index.emplace(key, m_entries.begin());
+        while (m_entries.size() > capacity)
+        {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+    }
+
+    static SPIRVTranslationCache& get()
+    {
+        static SPIRVTranslationCache cache;
+        return cache;
+    }
+
+private:
+    using Entry = std::pair<Key, std::string>;
+    std::list<Entry> m_entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+    LockStats::InstrumentedMutex m_mutex{LockStats::LockId::SPIRVCache};
+};
+
 // Translate SPIR-V binary to LLVM Module
 bool TranslateSPIRVToLLVM(
     const STB_TranslateInputArgs& InputArgs,
@@ -434,41 +562,72 @@ bool TranslateSPIRVToLLVM(
     std::string& stringErrMsg)
 {
     bool success = true;
-    std::istringstream IS(SPIRVBinary.str());
+    // Parse straight from the caller's buffer; SPIR-V modules can be tens of
+    // megabytes and a std::istringstream would copy them.
+    Util::MemoryInputStream IS(SPIRVBinary.data(), SPIRVBinary.size());
     std::unordered_map<uint32_t, uint64_t> specIDToSpecValueMap = UnpackSpecConstants(
         InputArgs.pSpecConstantsIds,
         InputArgs.pSpecConstantsValues,
         InputArgs.SpecConstantsSize);
 
 #if defined(IGC_SCALAR_USE_KHRONOS_SPIRV_TRANSLATOR)
-    // Set SPIRV-LLVM-Translator translation options
-    SPIRV::TranslatorOpts Opts;
-    Opts.enableGenArgNameMD();
-    Opts.enableAllExtensions();
-    Opts.setDesiredBIsRepresentation(SPIRV::BIsRepresentation::SPIRVFriendlyIR);
-
-    // This option has to be enabled since SPIRV-Translator for LLVM13 because of:
-    // https://github.com/KhronosGroup/SPIRV-LLVM-Translator/commit/835eb7e. This change
-    // has been also backported to SPIRV-Translator for LLVM11.
-#if LLVM_VERSION_MAJOR >= 13 || LLVM_VERSION_MAJOR == 11
-    Opts.setPreserveOCLKernelArgTypeMetadataThroughString(true);
+    // The translator options are fixed below.
+    const uint32_t readerFlags = SPIRVTranslationCache::KhronosTranslator;
+#else
+    const bool lazyTranslation = IGC_IS_FLAG_ENABLED(EnableSPIRVLazyFunctionTranslation);
+    const uint32_t readerFlags =
+        lazyTranslation ? SPIRVTranslationCache::LazyFunctionTranslation : 0;
 #endif
 
-    // Unpack specialization constants passed from OCL Runtime (Acquired from
-    // clSetProgramSpecializationConstant API call). It is also passed as a
-    // translation options.
-    if (InputArgs.SpecConstantsSize)
+    const unsigned cacheSize = IGC_GET_FLAG_VALUE(SPIRVTranslationCacheSize);
+    SPIRVTranslationCache::Key cacheKey{};
+    bool cacheHit = false;
+    if (cacheSize)
     {
-        for (const auto& SC : specIDToSpecValueMap)
-            Opts.setSpecConst(SC.first, SC.second);
+        cacheKey = SPIRVTranslationCache::makeKey(SPIRVBinary, specIDToSpecValueMap, readerFlags);
+        if (auto Cached = SPIRVTranslationCache::get().lookup(cacheKey, Context))
+        {
+            LLVMModule = Cached.release();
+            cacheHit = true;
+        }
     }
 
-    // Actual translation from SPIR-V to LLLVM
-    success = llvm::readSpirv(Context, Opts, IS, LLVMModule, stringErrMsg);
+    if (!cacheHit)
+    {
+#if defined(IGC_SCALAR_USE_KHRONOS_SPIRV_TRANSLATOR)
+        // Set SPIRV-LLVM-Translator translation options
+        SPIRV::TranslatorOpts Opts;
+        Opts.enableGenArgNameMD();
+        Opts.enableAllExtensions();
+        Opts.setDesiredBIsRepresentation(SPIRV::BIsRepresentation::SPIRVFriendlyIR);
+
+        // This option has to be enabled since SPIRV-Translator for LLVM13 because of:
+        // https://github.com/KhronosGroup/SPIRV-LLVM-Translator/commit/835eb7e. This change
+        // has been also backported to SPIRV-Translator for LLVM11.
+#if LLVM_VERSION_MAJOR >= 13 || LLVM_VERSION_MAJOR == 11
+        Opts.setPreserveOCLKernelArgTypeMetadataThroughString(true);
+#endif
+
+        // Unpack specialization constants passed from OCL Runtime (Acquired from
+        // clSetProgramSpecializationConstant API call). It is also passed as a
+        // translation options.
+        if (InputArgs.SpecConstantsSize)
+        {
+            for (const auto& SC : specIDToSpecValueMap)
+                Opts.setSpecConst(SC.first, SC.second);
+        }
+
+        // Actual translation from SPIR-V to LLLVM
+        success = llvm::readSpirv(Context, Opts, IS, LLVMModule, stringErrMsg);
 #else // IGC Legacy SPIRV Translator
-    success = igc_spv::ReadSPIRV(Context, IS, LLVMModule, stringErrMsg, &specIDToSpecValueMap);
+        success = igc_spv::ReadSPIRV(Context, IS, LLVMModule, stringErrMsg, &specIDToSpecValueMap,
+            lazyTranslation);
 #endif
 
+        if (success && cacheSize)
+            SPIRVTranslationCache::get().insert(cacheKey, *LLVMModule, cacheSize);
+    }
+
     // Handle OpenCL Compiler Options
     if (success)
     {
@@ -1139,7 +1298,7 @@ bool TranslateBuildSPMD(
     // due static LLVM object which handles options.
     // Setting mutex to ensure that single thread will enter and setup this flag.
     {
-        const std::lock_guard<std::mutex> lock(llvm_mutex);
+        const std::lock_guard<LockStats::InstrumentedMutex> lock(llvm_mutex);
         // Disable code sinking in instruction combining.
         // This is a workaround for a performance issue caused by code sinking
         // that is being done in LLVM's instcombine pass.
@@ -1645,7 +1804,7 @@ bool TranslateBuildVC(
     // during multi-threaded compilations. The mutex below serializes
     // the whole compilation process.
     // This is a temporary measure till a proper re-design is done.
-    const std::lock_guard<std::mutex> lock(llvm_mutex);
+    const std::lock_guard<LockStats::InstrumentedMutex> lock(llvm_mutex);
 
     std::error_code status =
         vc::translateBuild(pInputArgs, pOutputArgs, inputDataFormatTemp,
@@ -1820,4 +1979,20 @@ TRANSLATION_BLOCK_API void Delete(CTranslationBlock* pTranslationBlock)
     CIGCTranslationBlock::Delete(pIGCTranslationBlock);
 }
 
+TRANSLATION_BLOCK_API uint32_t IGCGetLockStats(LockStats::Entry* pEntries, uint32_t numEntries)
+{
+    constexpr uint32_t numLocks = (uint32_t)LockStats::LockId::Count;
+    for (uint32_t i = 0; i < numLocks && i < numEntries && pEntries; i++)
+    {
+        auto id = (LockStats::LockId)i;
+        const LockStats::Counters& counters = LockStats::GetCounters(id);
+        LockStats::Entry& entry = pEntries[i];
+        strcpy_s(entry.name, sizeof(entry.name), LockStats::GetLockName(id));
+        entry.acquisitions = counters.acquisitions.load();
+        entry.contended = counters.contended.load();
+        entry.waitNs = counters.waitNs.load();
+    }
+    return numLocks;
+}
+
 } // namespace TC
@@ -21,6 +21,7 @@ SPDX-License-Identifier: MIT
 #include "ocl_igc_interface/impl/ocl_translation_output_impl.h"
 
 #include "AdaptorOCL/OCL/TB/igc_tb.h"
+#include "AdaptorOCL/OCL/util/MemoryInputStream.h"
 #include "common/debug/Debug.hpp"
 
 #include "cif/macros/enable.h"
@@ -181,8 +182,7 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
                 spvTextDestroy(spirvAsm);
 #endif // defined(IGC_SPIRV_TOOLS_ENABLED)
             }
-            llvm::StringRef strInput = llvm::StringRef(pInput, inputSize);
-            std::istringstream IS(strInput.str());
+            Util::MemoryInputStream IS(pInput, inputSize);
 
             // vector of pairs [spec_id, spec_size]
             std::vector<std::pair<uint32_t, uint32_t>> SCInfo;
@@ -284,7 +284,11 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
             }
         }
         bool RegFlagNameError = 0;
-        LoadRegistryKeys(RegKeysFlagsFromOptions, &RegFlagNameError);
+        LoadRegistryKeys();
+        // Regkeys from -igc_opts apply to this compile only, so that compiles
+        // with different -igc_opts can run concurrently.
+        auto regKeys = CreateRegKeySnapshot(RegKeysFlagsFromOptions, &RegFlagNameError);
+        RegKeySnapshotScope regKeysScope(regKeys.get());
         if(RegFlagNameError) outputInterface->GetImpl()->SetError(TranslationErrorType::Unused, "Invalid registry flag name in -igc_opts, at least one flag has been ignored");
 
         IGC::CPlatform igcPlatform = this->globalState.GetIgcCPlatform();
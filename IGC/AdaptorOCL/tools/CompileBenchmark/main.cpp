@@ -0,0 +1,428 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2023 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Throughput benchmark for concurrent in-process compiles through the CIF
+// interface, the way the OpenCL runtime drives IGC. Loads a corpus of SPIR-V
+// (.spv), LLVM bitcode (.bc) and LLVM text (.ll) files and compiles it from N
+// threads against a single device context. Reports throughput, p50/p99
+// latency of a compile and the time threads waited for the locks inside IGC
+// that serialize compiles. No GPU is needed, the target is given by name.
+//
+//   igc_compile_benchmark -threads 8 -iterations 4 -platform dg2 corpus/
+//
+// With -check-igc-opts it is a stress test for per-compile regkeys instead:
+// concurrent compiles alternate between -igc_opts 'EnableZEBinary=1' and
+// 'EnableZEBinary=0', and each output must be in the format its own options
+// asked for (ELF or patch tokens). Use a platform that supports both. The
+// check also loads a TuningDecisionFile that sets EnableZEBinary for a shader
+// outside the corpus, which must not change what the other compiles get.
+//
+//   igc_compile_benchmark -check-igc-opts -threads 16 -iterations 8 -platform tgllp corpus/
+
+#include "cif/common/cif_main.h"
+#include "cif/common/library_handle.h"
+#include "cif/import/cif_main.h"
+#include "cif/builtins/memory/buffer/buffer.h"
+#include "ocl_igc_interface/code_type.h"
+#include "ocl_igc_interface/igc_ocl_device_ctx.h"
+#include "ocl_igc_interface/igc_ocl_translation_ctx.h"
+#include "ocl_igc_interface/ocl_translation_output.h"
+#include "ocl_igc_interface/platform.h"
+#include "ocl_igc_interface/gt_system_info.h"
+#include "AdaptorOCL/TranslationBlock.h"
+#include "inc/common/igfxfmid.h"
+#include "inc/common/lock_stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct PlatformDesc
+{
+    const char* name;
+    PRODUCT_FAMILY productFamily;
+    GFXCORE_FAMILY renderCoreFamily;
+    unsigned short deviceId;
+    unsigned int euCount;
+    unsigned int threadsPerEU;
+    unsigned int sliceCount;
+    unsigned int subSliceCount;
+};
+
+const PlatformDesc Platforms[] = {
+    { "tgllp", IGFX_TIGERLAKE_LP, IGFX_GEN12LP_CORE, 0x9A49, 96,  7, 1, 6 },
+    { "dg2",   IGFX_DG2,          IGFX_XE_HPG_CORE,  0x56A0, 512, 8, 8, 32 },
+    { "pvc",   IGFX_PVC,          IGFX_XE_HPC_CORE,  0x0BD5, 1024, 8, 8, 64 },
+};
+
+struct Input
+{
+    std::string path;
+    IGC::CodeType::CodeType_t type;
+    std::vector<char> data;
+};
+
+struct Options
+{
+#if defined(_WIN32)
+    std::string library = "igc64.dll";
+#else
+    std::string library = "libigc.so";
+#endif
+    std::string platform = "dg2";
+    std::string options;
+    std::string internalOptions;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned iterations = 1;
+    bool checkIgcOpts = false;
+    std::vector<std::string> paths;
+};
+
+void Usage(const char* argv0)
+{
+    fprintf(stderr,
+        "usage: %s [-lib <IGC library>] [-platform tgllp|dg2|pvc] [-threads N]\n"
+        "          [-iterations N] [-options <str>] [-internal_options <str>]\n"
+        "          [-check-igc-opts] <file or directory>...\n", argv0);
+}
+
+bool ParseArgs(int argc, const char** argv, Options& opts)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-lib" && hasValue)
+            opts.library = argv[++i];
+        else if (arg == "-platform" && hasValue)
+            opts.platform = argv[++i];
+        else if (arg == "-threads" && hasValue)
+            opts.threads = std::max(1, atoi(argv[++i]));
+        else if (arg == "-iterations" && hasValue)
+            opts.iterations = std::max(1, atoi(argv[++i]));
+        else if (arg == "-options" && hasValue)
+            opts.options = argv[++i];
+        else if (arg == "-internal_options" && hasValue)
+            opts.internalOptions = argv[++i];
+        else if (arg == "-check-igc-opts")
+            opts.checkIgcOpts = true;
+        else if (!arg.empty() && arg[0] == '-')
+            return false;
+        else
+            opts.paths.push_back(arg);
+    }
+    return !opts.paths.empty();
+}
+
+bool GetCodeType(const fs::path& path, IGC::CodeType::CodeType_t& type)
+{
+    auto ext = path.extension().string();
+    if (ext == ".spv")
+        type = IGC::CodeType::spirV;
+    else if (ext == ".bc")
+        type = IGC::CodeType::llvmBc;
+    else if (ext == ".ll")
+        type = IGC::CodeType::llvmLl;
+    else
+        return false;
+    return true;
+}
+
+void AddInput(const fs::path& path, std::vector<Input>& corpus)
+{
+    Input input;
+    if (!GetCodeType(path, input.type))
+        return;
+    std::ifstream file(path, std::ios::binary);
+    input.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (input.type == IGC::CodeType::llvmLl)
+        input.data.push_back('\0');
+    if (input.data.empty())
+        return;
+    input.path = path.string();
+    corpus.push_back(std::move(input));
+}
+
+std::vector<Input> LoadCorpus(const std::vector<std::string>& paths)
+{
+    std::vector<Input> corpus;
+    for (auto& path : paths)
+    {
+        if (fs::is_directory(path))
+        {
+            for (auto& entry : fs::recursive_directory_iterator(path))
+            {
+                if (entry.is_regular_file())
+                    AddInput(entry.path(), corpus);
+            }
+        }
+        else
+        {
+            AddInput(path, corpus);
+        }
+    }
+    return corpus;
+}
+
+template <typename DeviceCtxT>
+void SetupDevice(DeviceCtxT& deviceCtx, const PlatformDesc& desc)
+{
+    deviceCtx.SetProfilingTimerResolution(1.0f);
+
+    auto platform = deviceCtx.GetPlatformHandle();
+    platform->SetProductFamily(desc.productFamily);
+    platform->SetRenderCoreFamily(desc.renderCoreFamily);
+    platform->SetDisplayCoreFamily(desc.renderCoreFamily);
+    platform->SetPlatformType(PLATFORM_NONE);
+    platform->SetDeviceID(desc.deviceId);
+    platform->SetRevId(0);
+    platform->SetGTType(GTTYPE_GT2);
+
+    auto gtSystemInfo = deviceCtx.GetGTSystemInfoHandle();
+    gtSystemInfo->SetEUCount(desc.euCount);
+    gtSystemInfo->SetThreadCount(desc.euCount * desc.threadsPerEU);
+    gtSystemInfo->SetSliceCount(desc.sliceCount);
+    gtSystemInfo->SetSubSliceCount(desc.subSliceCount);
+    gtSystemInfo->SetMaxEuPerSubSlice(desc.euCount / desc.subSliceCount);
+    gtSystemInfo->SetMaxSlicesSupported(desc.sliceCount);
+    gtSystemInfo->SetMaxSubSlicesSupported(desc.subSliceCount);
+    gtSystemInfo->SetMaxFillRate(8);
+}
+
+std::vector<LockStats::Entry> ReadLockStats(TC::PFNIGCGETLOCKSTATS getLockStats)
+{
+    std::vector<LockStats::Entry> stats;
+    if (getLockStats == nullptr)
+        return stats;
+    stats.resize(getLockStats(nullptr, 0));
+    getLockStats(stats.data(), (uint32_t)stats.size());
+    return stats;
+}
+
+bool IsZEBinary(const void* binary, size_t size)
+{
+    return size >= 4 && memcmp(binary, "\x7f" "ELF", 4) == 0;
+}
+
+// Writes a tuning decision for a hash that no corpus shader has and points
+// IGC at it. Must run before the first compile, which loads the regkeys.
+void SetUnlistedTuningDecision()
+{
+    fs::path path = fs::temp_directory_path() / "igc_compile_benchmark_tuning.txt";
+    std::ofstream file(path);
+    file << "hash:0x1\nEnableZEBinary=0\n";
+    file.close();
+#if defined(_WIN32)
+    _putenv_s("IGC_TuningDecisionFile", path.string().c_str());
+#else
+    setenv("IGC_TuningDecisionFile", path.string().c_str(), 1);
+#endif
+}
+
+double Percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+    size_t idx = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+} // namespace
+
+int main(int argc, const char** argv)
+{
+    Options opts;
+    if (!ParseArgs(argc, argv, opts))
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    auto desc = std::find_if(std::begin(Platforms), std::end(Platforms),
+        [&](const PlatformDesc& P) { return opts.platform == P.name; });
+    if (desc == std::end(Platforms))
+    {
+        fprintf(stderr, "unknown platform %s\n", opts.platform.c_str());
+        return 1;
+    }
+
+    std::vector<Input> corpus = LoadCorpus(opts.paths);
+    if (corpus.empty())
+    {
+        fprintf(stderr, "no .spv, .bc or .ll inputs found\n");
+        return 1;
+    }
+
+    if (opts.checkIgcOpts)
+        SetUnlistedTuningDecision();
+
+    auto library = CIF::OpenLibrary(opts.library, false);
+    if (!library)
+    {
+        fprintf(stderr, "could not load %s\n", opts.library.c_str());
+        return 1;
+    }
+    auto getLockStats = reinterpret_cast<TC::PFNIGCGETLOCKSTATS>(library->GetFuncPointer("IGCGetLockStats"));
+    auto igcMain = CIF::OpenLibraryInterface(std::move(library));
+    if (!igcMain || !igcMain->IsValid())
+    {
+        fprintf(stderr, "%s has no usable CIF interface\n", opts.library.c_str());
+        return 1;
+    }
+
+    auto deviceCtx = (*igcMain)->CreateInterface<IGC::IgcOclDeviceCtxTagOCL>();
+    if (!deviceCtx)
+    {
+        fprintf(stderr, "could not create a device context\n");
+        return 1;
+    }
+    SetupDevice(*deviceCtx, *desc);
+
+    // Compile every input once before measuring so that one-time
+    // initialization (regkeys, builtins, LLVM globals) is not counted.
+    // With -check-igc-opts, job N asks for zebin iff N is even, and a compile
+    // whose output has the other format saw the regkeys of another compile.
+    std::vector<bool> valid(corpus.size(), true);
+    std::atomic<unsigned> mismatches{0};
+    auto compile = [&](const Input& input, size_t job) {
+        std::string jobOptions = opts.options;
+        bool wantZEBinary = job % 2 == 0;
+        if (opts.checkIgcOpts)
+            jobOptions += wantZEBinary ? " -igc_opts 'EnableZEBinary=1'" : " -igc_opts 'EnableZEBinary=0'";
+
+        auto* main = igcMain->GetCIFMain();
+        auto src = CIF::Builtins::CreateConstBuffer(main, input.data.data(), input.data.size());
+        auto options = CIF::Builtins::CreateConstBuffer(main, jobOptions.c_str(), jobOptions.size() + 1);
+        auto internalOptions = CIF::Builtins::CreateConstBuffer(main, opts.internalOptions.c_str(), opts.internalOptions.size() + 1);
+        auto translationCtx = deviceCtx->CreateTranslationCtx(input.type, IGC::CodeType::oclGenBin);
+        if (!translationCtx)
+            return false;
+        auto output = translationCtx->Translate(src.get(), options.get(), internalOptions.get(), nullptr, 0);
+        if (!output || !output->Successful())
+            return false;
+        if (opts.checkIgcOpts)
+        {
+            auto binary = output->GetOutput();
+            if (!binary || IsZEBinary(binary->GetMemoryRaw(), binary->GetSizeRaw()) != wantZEBinary)
+                mismatches++;
+        }
+        return true;
+    };
+    for (size_t i = 0; i < corpus.size(); i++)
+    {
+        // Compile both formats up front, single threaded, so that inputs
+        // that fail or ignore one of them are skipped.
+        unsigned mismatchesBefore = mismatches;
+        valid[i] = compile(corpus[i], 0) && (!opts.checkIgcOpts || compile(corpus[i], 1)) &&
+            mismatches == mismatchesBefore;
+        if (!valid[i])
+            fprintf(stderr, "%s: compile failed, skipped\n", corpus[i].path.c_str());
+    }
+
+    std::vector<size_t> jobs;
+    for (unsigned it = 0; it < opts.iterations; it++)
+    {
+        for (size_t i = 0; i < corpus.size(); i++)
+        {
+            if (valid[i])
+                jobs.push_back(i);
+        }
+    }
+    if (jobs.empty() && mismatches)
+    {
+        // Either the platform ignores EnableZEBinary, or the unlisted tuning
+        // decision replaced the -igc_opts value of every shader.
+        fprintf(stderr, "no input got the binary format its -igc_opts asked for\n");
+        return 3;
+    }
+    if (jobs.empty())
+    {
+        fprintf(stderr, "no input compiled successfully\n");
+        return 1;
+    }
+
+    mismatches = 0;
+    auto locksBefore = ReadLockStats(getLockStats);
+
+    std::atomic<size_t> nextJob{0};
+    std::atomic<unsigned> failures{0};
+    std::vector<std::vector<double>> latencies(opts.threads);
+    auto worker = [&](unsigned tid) {
+        for (size_t job = nextJob++; job < jobs.size(); job = nextJob++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            bool ok = compile(corpus[jobs[job]], job);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            latencies[tid].push_back(elapsed.count());
+            if (!ok)
+                failures++;
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned tid = 0; tid < opts.threads; tid++)
+        threads.emplace_back(worker, tid);
+    for (auto& thread : threads)
+        thread.join();
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    auto locksAfter = ReadLockStats(getLockStats);
+
+    std::vector<double> all;
+    for (auto& perThread : latencies)
+        all.insert(all.end(), perThread.begin(), perThread.end());
+    std::sort(all.begin(), all.end());
+
+    printf("inputs:          %zu\n", corpus.size());
+    printf("compiles:        %zu (%u failed)\n", jobs.size(), failures.load());
+    printf("threads:         %u\n", opts.threads);
+    printf("wall time:       %.3f s\n", wall.count());
+    printf("throughput:      %.2f compiles/s\n", jobs.size() / wall.count());
+    printf("latency p50:     %.2f ms\n", Percentile(all, 0.50));
+    printf("latency p99:     %.2f ms\n", Percentile(all, 0.99));
+    if (opts.checkIgcOpts)
+    {
+        printf("igc_opts check:  %u compiles got the binary format of other -igc_opts\n", mismatches.load());
+        if (mismatches)
+            return 3;
+    }
+
+    if (locksAfter.empty())
+    {
+        printf("lock stats:      not available, library does not export IGCGetLockStats\n");
+        return failures ? 2 : 0;
+    }
+    printf("%-16s %12s %12s %12s %10s\n", "lock", "acquired", "contended", "wait ms", "wait %");
+    for (size_t i = 0; i < locksAfter.size(); i++)
+    {
+        const auto& after = locksAfter[i];
+        const auto& before = locksBefore[i];
+        double waitMs = (after.waitNs - before.waitNs) / 1e6;
+        // share of the total thread time spent waiting for this lock
+        double waitPct = 100.0 * waitMs / (wall.count() * 1e3 * opts.threads);
+        printf("%-16s %12llu %12llu %12.2f %9.2f%%\n", after.name,
+            (unsigned long long)(after.acquisitions - before.acquisitions),
+            (unsigned long long)(after.contended - before.contended),
+            waitMs, waitPct);
+    }
+    return failures ? 2 : 0;
+}
@@ -3936,6 +3936,10 @@ namespace IGC
         bool AllowSpill = true;
 
         SaveOption(vISA_Linker, IGC_GET_FLAG_VALUE(VISALTO));
+        if (IGC_GET_FLAG_VALUE(CompileMemoryBudgetMB))
+        {
+            SaveOption(vISA_MemBudgetMB, IGC_GET_FLAG_VALUE(CompileMemoryBudgetMB));
+        }
         if (context->type == ShaderType::OPENCL_SHADER)
         {
             auto ClContext = static_cast<OpenCLProgramContext*>(context);
@@ -4650,6 +4654,11 @@ namespace IGC
         {
             SaveOption(vISA_LinearScan, true);
         }
+        else if (context->type == ShaderType::OPENCL_SHADER &&
+            static_cast<OpenCLProgramContext*>(context)->m_InternalOptions.IntelUseLinearScanRA)
+        {
+            SaveOption(vISA_LinearScan, true);
+        }
 
         if (IGC_IS_FLAG_ENABLED(EnableIGASWSB))
         {
@@ -6099,6 +6108,8 @@ namespace IGC
         }
 
         m_program->m_asmInstrCount = jitInfo->stats.numAsmCountUnweighted;
+        context->m_peakVISAMemoryKB =
+            std::max(context->m_peakVISAMemoryKB, jitInfo->stats.peakMemoryKB);
 
         if (m_vIsaCompileStatus == VISA_FAILURE)
         {
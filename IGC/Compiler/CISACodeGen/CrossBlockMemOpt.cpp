@@ -0,0 +1,413 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2023 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/Analysis/AliasAnalysis.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/PostDominators.h>
+#include <llvm/Analysis/ScalarEvolution.h>
+#include <llvm/Analysis/ScalarEvolutionExpressions.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Dominators.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Pass.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/Local.h>
+#include <llvmWrapper/Analysis/MemoryLocation.h>
+#include <llvmWrapper/Support/Alignment.h>
+#include "common/LLVMWarningsPop.hpp"
+#include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/MetaDataUtilsWrapper.h"
+#include "Compiler/CISACodeGen/CrossBlockMemOpt.h"
+#include "Probe/Assertion.h"
+
+using namespace llvm;
+using namespace IGC;
+using namespace IGC::IGCMD;
+
+namespace {
+
+    // MemOpt only merges loads and stores within a block. This pass brings
+    // accesses of neighbouring blocks together so that it can merge them too:
+    // - A load of block BB is hoisted to the end of its immediate dominator
+    //   Lead if BB post-dominates Lead in the same loop, i.e. both always run
+    //   together, Lead loads close to it, and nothing on the way may write the
+    //   loaded location.
+    // - A store of Lead is sunk to the beginning of such a BB if BB stores
+    //   close to it and nothing on the way may access the stored location.
+    // - Loads of the same address at the top of both arms of an if/else are
+    //   replaced by one load at the end of the branching block.
+    // Whether two locations may alias is left to alias analysis, which knows
+    // that distinct address spaces do not.
+    class CrossBlockMemOpt : public FunctionPass {
+        AliasAnalysis* AA;
+        DominatorTree* DT;
+        PostDominatorTree* PDT;
+        LoopInfo* LI;
+        ScalarEvolution* SE;
+
+        // Only needed for PrintCrossBlockMemOptStats.
+        bool CollectStats = false;
+        unsigned NumMergedLoads = 0;
+
+        // Accesses are only moved next to accesses at most this many bytes
+        // apart, which is what MemOpt can merge into one message.
+        static const int64_t MaxDistance = 64;
+        // Upper bound of the blocks between Lead and BB.
+        static const unsigned MaxRegionSize = 16;
+
+    public:
+        static char ID;
+
+        CrossBlockMemOpt() : FunctionPass(ID) {
+            initializeCrossBlockMemOptPass(*PassRegistry::getPassRegistry());
+        }
+
+        bool runOnFunction(Function& F) override;
+
+        StringRef getPassName() const override { return "Cross-block MemOpt"; }
+
+    private:
+        void getAnalysisUsage(AnalysisUsage& AU) const override {
+            AU.setPreservesCFG();
+            AU.addRequired<MetaDataUtilsWrapper>();
+            AU.addRequired<AAResultsWrapperPass>();
+            AU.addRequired<DominatorTreeWrapperPass>();
+            AU.addRequired<PostDominatorTreeWrapperPass>();
+            AU.addRequired<LoopInfoWrapperPass>();
+            AU.addRequired<ScalarEvolutionWrapperPass>();
+        }
+
+        bool mergeArmLoads(BasicBlock* BB);
+        bool hoistLoads(BasicBlock* Lead, BasicBlock* BB);
+        bool sinkStores(BasicBlock* Lead, BasicBlock* BB);
+
+        bool collectRegion(BasicBlock* Lead, BasicBlock* BB,
+            SmallVectorImpl<BasicBlock*>& Region) const;
+        bool collectOperandInst(SmallPtrSetImpl<Instruction*>& Set,
+            Instruction* Inst, BasicBlock* Lead) const;
+        bool hoistInst(Instruction* Inst, BasicBlock* Lead) const;
+        bool hasNearbyAccess(Instruction* I,
+            ArrayRef<Instruction*> Candidates) const;
+        bool isIndependent(const MemoryLocation& Loc,
+            ArrayRef<Instruction*> Insts, bool IncludeReads) const;
+
+        void markMoved(Instruction* I) const {
+            if (CollectStats)
+                I->setMetadata(CrossBlockMovedMDName, MDNode::get(I->getContext(), {}));
+        }
+
+        static bool isSimpleAccess(const Instruction* I) {
+            if (auto* LD = dyn_cast<LoadInst>(I))
+                return LD->isSimple();
+            if (auto* ST = dyn_cast<StoreInst>(I))
+                return ST->isSimple();
+            return false;
+        }
+    };
+
+    char CrossBlockMemOpt::ID = 0;
+
+} // End anonymous namespace
+
+FunctionPass* IGC::createCrossBlockMemOptPass() {
+    return new CrossBlockMemOpt();
+}
+
+#define PASS_FLAG     "igc-crossblock-memopt"
+#define PASS_DESC     "Cross-block Memory Optimization"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(CrossBlockMemOpt, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+    IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+    IGC_INITIALIZE_PASS_DEPENDENCY(AAResultsWrapperPass)
+    IGC_INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
+    IGC_INITIALIZE_PASS_DEPENDENCY(PostDominatorTreeWrapperPass)
+    IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
+    IGC_INITIALIZE_PASS_DEPENDENCY(ScalarEvolutionWrapperPass);
+IGC_INITIALIZE_PASS_END(CrossBlockMemOpt, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+bool CrossBlockMemOpt::runOnFunction(Function& F) {
+    // Skip non-kernel function.
+    MetaDataUtils* MDU = nullptr;
+    MDU = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+    auto FII = MDU->findFunctionsInfoItem(&F);
+    if (FII == MDU->end_FunctionsInfo())
+        return false;
+
+    AA = &getAnalysis<AAResultsWrapperPass>().getAAResults();
+    DT = &getAnalysis<DominatorTreeWrapperPass>().getDomTree();
+    PDT = &getAnalysis<PostDominatorTreeWrapperPass>().getPostDomTree();
+    LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+    SE = &getAnalysis<ScalarEvolutionWrapperPass>().getSE();
+
+    CollectStats = IGC_IS_FLAG_ENABLED(PrintCrossBlockMemOptStats);
+    NumMergedLoads = 0;
+
+    bool Changed = false;
+    ReversePostOrderTraversal<Function*> RPOT(&F);
+    for (BasicBlock* BB : RPOT) {
+        Changed |= mergeArmLoads(BB);
+
+        DomTreeNode* Node = DT->getNode(BB);
+        if (!Node || !Node->getIDom())
+            continue;
+        BasicBlock* Lead = Node->getIDom()->getBlock();
+        // BB runs exactly once per run of Lead.
+        if (!PDT->dominates(BB, Lead) ||
+            LI->getLoopFor(BB) != LI->getLoopFor(Lead))
+            continue;
+        Changed |= hoistLoads(Lead, BB);
+        Changed |= sinkStores(Lead, BB);
+    }
+
+    // Each merge of arm loads leaves one load message instead of two. The
+    // moved accesses only pay off if MemOpt merges them, which it reports.
+    if (CollectStats && NumMergedLoads > 0) {
+        LLVMContext& Ctx = F.getContext();
+        F.setMetadata(CrossBlockMergedMDName, MDNode::get(Ctx,
+            ConstantAsMetadata::get(ConstantInt::get(Type::getInt32Ty(Ctx), NumMergedLoads))));
+    }
+    return Changed;
+}
+
+bool CrossBlockMemOpt::mergeArmLoads(BasicBlock* BB) {
+    auto* BI = dyn_cast<BranchInst>(BB->getTerminator());
+    if (!BI || !BI->isConditional())
+        return false;
+    BasicBlock* Then = BI->getSuccessor(0);
+    BasicBlock* Else = BI->getSuccessor(1);
+    if (Then == Else ||
+        Then->getSinglePredecessor() != BB ||
+        Else->getSinglePredecessor() != BB)
+        return false;
+
+    // Loads before the first instruction that may write memory read the same
+    // value at the end of BB.
+    auto collectTopLoads = [](BasicBlock* Arm, SmallVectorImpl<LoadInst*>& Loads) {
+        for (auto& I : *Arm) {
+            if (I.mayWriteToMemory())
+                break;
+            auto* LD = dyn_cast<LoadInst>(&I);
+            if (LD && LD->isSimple())
+                Loads.push_back(LD);
+        }
+    };
+    SmallVector<LoadInst*, 8> ThenLoads;
+    SmallVector<LoadInst*, 8> ElseLoads;
+    collectTopLoads(Then, ThenLoads);
+    collectTopLoads(Else, ElseLoads);
+
+    bool Changed = false;
+    for (LoadInst* ThenLD : ThenLoads) {
+        Value* Ptr = ThenLD->getPointerOperand();
+        auto* PtrInst = dyn_cast<Instruction>(Ptr);
+        if (PtrInst && !DT->dominates(PtrInst, BI))
+            continue;
+        for (LoadInst*& ElseLD : ElseLoads) {
+            if (!ElseLD ||
+                ElseLD->getPointerOperand() != Ptr ||
+                ElseLD->getType() != ThenLD->getType())
+                continue;
+
+            ThenLD->moveBefore(BI);
+            if (IGCLLVM::getAlignmentValue(ElseLD) < IGCLLVM::getAlignmentValue(ThenLD))
+                ThenLD->setAlignment(IGCLLVM::getAlign(*ElseLD));
+            combineMetadataForCSE(ThenLD, ElseLD, true);
+            ThenLD->applyMergedLocation(ThenLD->getDebugLoc(), ElseLD->getDebugLoc());
+            ElseLD->replaceAllUsesWith(ThenLD);
+            ElseLD->eraseFromParent();
+            ElseLD = nullptr;
+
+            markMoved(ThenLD);
+            ++NumMergedLoads;
+            Changed = true;
+            break;
+        }
+    }
+    return Changed;
+}
+
+bool CrossBlockMemOpt::hoistLoads(BasicBlock* Lead, BasicBlock* BB) {
+    SmallVector<Instruction*, 8> LeadLoads;
+    for (auto& I : *Lead)
+        if (isa<LoadInst>(&I) && isSimpleAccess(&I))
+            LeadLoads.push_back(&I);
+    if (LeadLoads.empty())
+        return false;
+
+    SmallVector<BasicBlock*, 8> Region;
+    if (!collectRegion(Lead, BB, Region))
+        return false;
+
+    // Keep the moved loads within the window MemOpt looks at.
+    const unsigned Limit = IGC_GET_FLAG_VALUE(MemOptWindowSize);
+    unsigned Distance = 0;
+    SmallVector<Instruction*, 16> Writes;
+    for (BasicBlock* RegionBB : Region) {
+        for (auto& I : *RegionBB) {
+            if (I.mayWriteToMemory())
+                Writes.push_back(&I);
+        }
+        Distance += (unsigned)RegionBB->size();
+    }
+
+    bool Changed = false;
+    for (auto II = BB->getFirstNonPHI()->getIterator(), IE = BB->end();
+        II != IE && ++Distance <= Limit; /*EMPTY*/) {
+        Instruction* I = &*II++;
+        if (isa<LoadInst>(I) && isSimpleAccess(I) &&
+            hasNearbyAccess(I, LeadLoads) &&
+            isIndependent(MemoryLocation::get(cast<LoadInst>(I)), Writes, false) &&
+            hoistInst(I, Lead)) {
+            markMoved(I);
+            Changed = true;
+            continue;
+        }
+        if (I->mayWriteToMemory())
+            Writes.push_back(I);
+    }
+    return Changed;
+}
+
+bool CrossBlockMemOpt::sinkStores(BasicBlock* Lead, BasicBlock* BB) {
+    const unsigned Limit = IGC_GET_FLAG_VALUE(MemOptWindowSize);
+    SmallVector<Instruction*, 8> BBStores;
+    unsigned Pos = 0;
+    for (auto& I : *BB) {
+        if (++Pos > Limit)
+            break;
+        if (isa<StoreInst>(&I) && isSimpleAccess(&I))
+            BBStores.push_back(&I);
+    }
+    if (BBStores.empty())
+        return false;
+
+    SmallVector<BasicBlock*, 8> Region;
+    if (!collectRegion(Lead, BB, Region))
+        return false;
+
+    unsigned Distance = 0;
+    SmallVector<Instruction*, 16> Accesses;
+    for (BasicBlock* RegionBB : Region) {
+        for (auto& I : *RegionBB) {
+            if (I.mayReadOrWriteMemory())
+                Accesses.push_back(&I);
+        }
+        Distance += (unsigned)RegionBB->size();
+    }
+
+    bool Changed = false;
+    // Walk Lead backwards so that the sunk stores keep their order.
+    Instruction* InsertPos = &*BB->getFirstInsertionPt();
+    for (auto II = Lead->rbegin(), IE = Lead->rend();
+        II != IE && ++Distance <= Limit; /*EMPTY*/) {
+        Instruction* I = &*II++;
+        if (isa<StoreInst>(I) && isSimpleAccess(I) &&
+            hasNearbyAccess(I, BBStores) &&
+            isIndependent(MemoryLocation::get(cast<StoreInst>(I)), Accesses, true)) {
+            I->moveBefore(InsertPos);
+            InsertPos = I;
+            markMoved(I);
+            Changed = true;
+            continue;
+        }
+        if (I->mayReadOrWriteMemory())
+            Accesses.push_back(I);
+    }
+    return Changed;
+}
+
+// Collects the blocks on the paths from Lead to BB, both excluded. Returns
+// false if there are too many of them or if Lead is reached again.
+bool CrossBlockMemOpt::collectRegion(BasicBlock* Lead, BasicBlock* BB,
+    SmallVectorImpl<BasicBlock*>& Region) const {
+    SmallPtrSet<BasicBlock*, 16> Visited;
+    SmallVector<BasicBlock*, 16> Worklist(succ_begin(Lead), succ_end(Lead));
+    while (!Worklist.empty()) {
+        BasicBlock* Curr = Worklist.pop_back_val();
+        if (Curr == BB || !Visited.insert(Curr).second)
+            continue;
+        if (Curr == Lead || Region.size() == MaxRegionSize)
+            return false;
+        Region.push_back(Curr);
+        Worklist.append(succ_begin(Curr), succ_end(Curr));
+    }
+    return true;
+}
+
+// Collects Inst and the instructions of its block it depends on. Returns
+// false if one of them can not be moved to the end of Lead.
+bool CrossBlockMemOpt::collectOperandInst(SmallPtrSetImpl<Instruction*>& Set,
+    Instruction* Inst, BasicBlock* Lead) const {
+    for (Value* V : Inst->operands()) {
+        Instruction* I = dyn_cast<Instruction>(V);
+        if (!I || Set.count(I))
+            continue;
+        if (I->getParent() != Inst->getParent()) {
+            if (DT->dominates(I->getParent(), Lead))
+                continue;
+            return false;
+        }
+        if (isa<PHINode>(I) ||
+            I->mayHaveSideEffects() ||
+            I->mayReadOrWriteMemory())
+            return false;
+        if (!collectOperandInst(Set, I, Lead))
+            return false;
+    }
+    Set.insert(Inst);
+    return true;
+}
+
+bool CrossBlockMemOpt::hoistInst(Instruction* Inst, BasicBlock* Lead) const {
+    SmallPtrSet<Instruction*, 16> ToHoist;
+    if (!collectOperandInst(ToHoist, Inst, Lead))
+        return false;
+    BasicBlock* FromBB = Inst->getParent();
+    Instruction* Pos = Lead->getTerminator();
+    for (auto II = FromBB->getFirstNonPHI()->getIterator(),
+        IE = FromBB->end(); II != IE && !ToHoist.empty(); /*EMPTY*/) {
+        Instruction* I = &*II++;
+        if (ToHoist.erase(I))
+            I->moveBefore(Pos);
+    }
+    return true;
+}
+
+// Returns true if one of Candidates accesses memory at most MaxDistance bytes
+// away from I.
+bool CrossBlockMemOpt::hasNearbyAccess(Instruction* I,
+    ArrayRef<Instruction*> Candidates) const {
+    Value* Ptr = getLoadStorePointerOperand(I);
+    unsigned AS = Ptr->getType()->getPointerAddressSpace();
+    const SCEV* PtrSCEV = SE->getSCEV(Ptr);
+    for (Instruction* Candidate : Candidates) {
+        Value* CandidatePtr = getLoadStorePointerOperand(Candidate);
+        if (CandidatePtr->getType()->getPointerAddressSpace() != AS)
+            continue;
+        auto* Dist = dyn_cast<SCEVConstant>(
+            SE->getMinusSCEV(PtrSCEV, SE->getSCEV(CandidatePtr)));
+        if (Dist && std::abs(Dist->getAPInt().getSExtValue()) <= MaxDistance)
+            return true;
+    }
+    return false;
+}
+
+// Returns true if none of Insts may write Loc or, with IncludeReads, read it.
+bool CrossBlockMemOpt::isIndependent(const MemoryLocation& Loc,
+    ArrayRef<Instruction*> Insts, bool IncludeReads) const {
+    for (Instruction* I : Insts) {
+        ModRefInfo MRI = AA->getModRefInfo(I, Loc);
+        if (IncludeReads ? isModOrRefSet(MRI) : isModSet(MRI))
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,29 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2023 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef _CISA_CROSSBLOCKMEMOPT_H_
+#define _CISA_CROSSBLOCKMEMOPT_H_
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include <llvm/PassRegistry.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+
+namespace IGC {
+    llvm::FunctionPass* createCrossBlockMemOptPass();
+
+    // With PrintCrossBlockMemOptStats, CrossBlockMemOpt tags the accesses it
+    // moved and records how many loads it merged on the function. MemOpt then
+    // reports the messages eliminated, counting the merges of tagged accesses.
+    const char* const CrossBlockMovedMDName = "igc.crossblock.memopt.moved";
+    const char* const CrossBlockMergedMDName = "igc.crossblock.memopt.merged";
+} // End namespace IGC
+
+#endif // _CISA_CROSSBLOCKMEMOPT_H_
@@ -15,6 +15,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/IGCPassSupport.h"
 #include "Compiler/MetaDataUtilsWrapper.h"
 #include "common/igc_regkeys.hpp"
+#include "common/debug/Debug.hpp"
 #include "common/LLVMWarningsPush.hpp"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/IR/Argument.h"
@@ -168,12 +169,27 @@ void GenXCodeGenModule::processFunction(Function& F)
         return false;
     };
 
+    auto exceedsCloningThreshold = [&CallerFGs](unsigned Threshold)->bool {
+        return Threshold > 0 && CallerFGs.size() > Threshold;
+    };
+
+    // A subroutine can be shared by turning it into a stack call. Its implicit
+    // arguments come from the kernel payload of the caller and can't be passed
+    // by the stack call ABI, so keep cloning those, and those without metadata.
+    auto canShareSubroutine = [&](llvm::Function* F)->bool {
+        if (!exceedsCloningThreshold(m_SubroutineSharingThreshold) || F->isVarArg())
+            return false;
+        auto FII = pMdUtils->findFunctionsInfoItem(F);
+        if (FII == pMdUtils->end_FunctionsInfo())
+            return false;
+        return FII->second->size_ImplicitArgInfoList() == 0;
+    };
+
     // Make the function indirect if cloning exceeds the threshold
     // We shouldn't add "referenced-indirectly" attr for builtins
-    if (F.hasFnAttribute("visaStackCall") &&
+    bool isStackCall = F.hasFnAttribute("visaStackCall");
+    if ((isStackCall ? exceedsCloningThreshold(m_FunctionCloningThreshold) : canShareSubroutine(&F)) &&
         !F.hasFnAttribute(llvm::Attribute::Builtin) &&
-        m_FunctionCloningThreshold > 0 &&
-        CallerFGs.size() > m_FunctionCloningThreshold &&
         !hasUnsupportedCallsInFuncWithStackCalls(&F) &&
         // Don't override the FunctionControl flags used for debugging
         IGC_GET_FLAG_VALUE(FunctionControl) == FLAG_FCALL_DEFAULT &&
@@ -187,6 +203,13 @@ void GenXCodeGenModule::processFunction(Function& F)
             {
                 std::cout << "Don't Clone: " << F.getName().str() << std::endl;
             }
+            if (!isStackCall)
+            {
+                F.addFnAttr("visaStackCall");
+                m_NumSharedFuncs++;
+                m_NumClonesAvoided += CallerFGs.size() - 1;
+                m_NumInstsNotCloned += (CallerFGs.size() - 1) * F.getInstructionCount();
+            }
             F.addFnAttr("referenced-indirectly");
             pCtx->m_enableFunctionPointer = true;
             FGA->addToFunctionGroup(&F, IFG, &F);
@@ -426,6 +449,15 @@ bool GenXCodeGenModule::runOnModule(Module& M)
         m_FunctionCloningThreshold = IGC_GET_FLAG_VALUE(FunctionCloningThreshold);
     }
 
+    // Sharing subroutines relies on the relocations of zebin to resolve the
+    // address of the single copy in every kernel. It has its own threshold so
+    // that enabling it doesn't change how stack-call functions are cloned.
+    if (IGC_IS_FLAG_ENABLED(ShareSubroutinesAcrossKernels) &&
+        getAnalysis<CodeGenContextWrapper>().getCodeGenContext()->enableZEBinary())
+    {
+        m_SubroutineSharingThreshold = m_FunctionCloningThreshold > 0 ? m_FunctionCloningThreshold : 1;
+    }
+
     pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
     CallGraph& CG = getAnalysis<CallGraphWrapperPass>().getCallGraph();
 
@@ -527,6 +559,13 @@ bool GenXCodeGenModule::runOnModule(Module& M)
         }
     }
 
+    if (IGC_IS_FLAG_ENABLED(PrintStackCallDebugInfo) && m_NumSharedFuncs > 0)
+    {
+        IGC::Debug::ods() << "Shared functions: " << m_NumSharedFuncs
+                          << ", clones avoided: " << m_NumClonesAvoided
+                          << ", LLVM instructions not cloned: " << m_NumInstsNotCloned << "\n";
+    }
+
     IGC_ASSERT(FGA->verify());
 
     FGA->setModule(&M);
@@ -53,6 +53,12 @@ namespace IGC {
         IGC::IGCMD::MetaDataUtils* pMdUtils;
         bool Modified;
         unsigned m_FunctionCloningThreshold = 0;
+        // Threshold for subroutines shared by ShareSubroutinesAcrossKernels, 0 if disabled
+        unsigned m_SubroutineSharingThreshold = 0;
+        // What sharing functions instead of cloning them saved
+        unsigned m_NumSharedFuncs = 0;
+        unsigned m_NumClonesAvoided = 0;
+        unsigned m_NumInstsNotCloned = 0;
     };
 
     /// \brief A collection of functions that are reachable from a kernel.
@@ -20,6 +20,7 @@ SPDX-License-Identifier: MIT
 #include <llvm/IR/Function.h>
 #include <llvm/IR/GetElementPtrTypeIterator.h>
 #include <llvm/IR/GlobalAlias.h>
+#include <llvm/IR/InstIterator.h>
 #include <llvmWrapper/IR/IRBuilder.h>
 #include <llvm/Pass.h>
 #include <llvmWrapper/Support/Alignment.h>
@@ -35,6 +36,8 @@ SPDX-License-Identifier: MIT
 #include "Compiler/MetaDataUtilsWrapper.h"
 #include "Compiler/CISACodeGen/WIAnalysis.hpp"
 #include "Compiler/CISACodeGen/MemOpt.h"
+#include "Compiler/CISACodeGen/CrossBlockMemOpt.h"
+#include "common/debug/Debug.hpp"
 #include "Probe/Assertion.h"
 
 using namespace llvm;
@@ -81,6 +84,10 @@ namespace {
         typedef DenseMap<unsigned int, SmallVector<unsigned, 4> > ProfitVectorLengthsMap;
         ProfitVectorLengthsMap ProfitVectorLengths;
 
+        // Messages eliminated by merging accesses CrossBlockMemOpt moved, for
+        // PrintCrossBlockMemOptStats.
+        unsigned NumCrossBlockMsgsEliminated = 0;
+
         // A list of memory references (within a BB) with the distance to the begining of the BB.
         typedef std::vector<std::pair<Instruction*, unsigned> > MemRefListTy;
         typedef std::vector<Instruction*> TrivialMemRefListTy;
@@ -111,6 +118,9 @@ namespace {
 
         void buildProfitVectorLengths(Function& F);
 
+        void countCrossBlockMerge(unsigned NumMerged, unsigned NumMoved);
+        void reportCrossBlockStats(Function& F);
+
         bool mergeLoad(LoadInst* LeadingLoad, MemRefListTy::iterator MI,
             MemRefListTy& MemRefs, TrivialMemRefListTy& ToOpt);
         bool mergeStore(StoreInst* LeadingStore, MemRefListTy::iterator MI,
@@ -534,6 +544,9 @@ bool MemOpt::runOnFunction(Function& F) {
             Changed |= optimizeGEP64(I);
     }
 
+    if (IGC_IS_FLAG_ENABLED(PrintCrossBlockMemOptStats))
+        reportCrossBlockStats(F);
+
     DL = nullptr;
     AA = nullptr;
     SE = nullptr;
@@ -541,6 +554,30 @@ bool MemOpt::runOnFunction(Function& F) {
     return Changed;
 }
 
+// NumMerged accesses became one message. Without CrossBlockMemOpt the
+// NumMoved accesses it moved into this block would have stayed apart.
+void MemOpt::countCrossBlockMerge(unsigned NumMerged, unsigned NumMoved) {
+    if (NumMerged > 1)
+        NumCrossBlockMsgsEliminated += std::min(NumMoved, NumMerged - 1);
+}
+
+void MemOpt::reportCrossBlockStats(Function& F) {
+    unsigned NumEliminated = NumCrossBlockMsgsEliminated;
+    NumCrossBlockMsgsEliminated = 0;
+    if (MDNode* MergedMD = F.getMetadata(CrossBlockMergedMDName)) {
+        NumEliminated += (unsigned)mdconst::extract<ConstantInt>(
+            MergedMD->getOperand(0))->getZExtValue();
+        F.setMetadata(CrossBlockMergedMDName, nullptr);
+    }
+    for (auto& I : instructions(F))
+        I.setMetadata(CrossBlockMovedMDName, nullptr);
+
+    if (NumEliminated > 0) {
+        IGC::Debug::ods() << "CrossBlockMemOpt: " << F.getName()
+            << ": memory messages eliminated: " << NumEliminated << "\n";
+    }
+}
+
 //This function removes redundant blockread instructions
 //if they read from addresses with the same base.
 //It replaces redundant blockread with a set of shuffle instructions.
@@ -1317,11 +1354,15 @@ bool MemOpt::mergeLoad(LoadInst* LeadingLoad,
     Instruction* NewOne = NewLoad;
     std::swap(ToOpt.back(), NewOne);
 
+    unsigned NumMerged = 0;
+    unsigned NumMoved = 0;
     for (auto& I : LoadsToMerge) {
         LoadInst* LD = cast<LoadInst>(std::get<0>(I));
         Value* Ptr = LD->getPointerOperand();
         // make sure the load was merged before actually removing it
         if (LD->use_empty()) {
+            ++NumMerged;
+            NumMoved += LD->getMetadata(CrossBlockMovedMDName) != nullptr;
             LD->eraseFromParent();
         }
         RecursivelyDeleteTriviallyDeadInstructions(Ptr);
@@ -1329,6 +1370,7 @@ bool MemOpt::mergeLoad(LoadInst* LeadingLoad,
         // Also, skip updating distance as the Window size is just a heuristic.
         std::get<2>(I)->first = nullptr;
     }
+    countCrossBlockMerge(NumMerged, NumMoved);
 
     // Add merged load into the leading load position in MemRefListTy
     // so that MemRefList is still valid and can be reused.
@@ -1633,9 +1675,11 @@ bool MemOpt::mergeStore(StoreInst* LeadingStore,
     Instruction* NewOne = NewStore;
     std::swap(ToOpt.back(), NewOne);
 
+    unsigned NumMoved = 0;
     for (auto& I : StoresToMerge) {
         StoreInst* ST = cast<StoreInst>(std::get<0>(I));
         Value* Ptr = ST->getPointerOperand();
+        NumMoved += ST->getMetadata(CrossBlockMovedMDName) != nullptr;
         // Stores merged in the previous iterations can get merged again, so we need
         // to update ToOpt vector to avoid null instruction in there
         ToOpt.erase(std::remove(ToOpt.begin(), ToOpt.end(), ST), ToOpt.end());
@@ -1657,6 +1701,7 @@ bool MemOpt::mergeStore(StoreInst* LeadingStore,
         }
 
     }
+    countCrossBlockMerge((unsigned)StoresToMerge.size(), NumMoved);
     return true;
 }
 
@@ -357,6 +357,12 @@ namespace IGC
             {
                 IntelEnablePreRAScheduling = false;
             }
+            // -cl-intel-linear-scan-ra, -ze-intel-linear-scan-ra
+            // Use the linear-scan allocator (with spilling) as a fast compile tier
+            else if (suffix.equals("-linear-scan-ra"))
+            {
+                IntelUseLinearScanRA = true;
+            }
             // -cl-intel-no-local-to-generic
             else if (suffix.equals("-no-local-to-generic"))
             {
@@ -3588,7 +3594,13 @@ namespace IGC
                 pass1Mode = SIMDMode::SIMD16;
                 pass2Mode = SIMDMode::SIMD8;
             }
+            // Work-item dependency does not depend on the SIMD width and the IR
+            // is not modified between the two pass managers, so the second one
+            // reuses the WIAnalysis results of the first instead of recomputing.
+            WIAnalysisCache wiCache;
+
             // Run first pass
+            Passes.add(new WIAnalysisCacheWrapper(&wiCache, false));
             AddCodeGenPasses(*ctx, shaders, Passes, pass1Mode, false);
             Passes.run(*(ctx->getModule()));
 
@@ -3597,6 +3609,7 @@ namespace IGC
             // Add required immutable passes
             Passes2.add(new MetaDataUtilsWrapper(ctx->getMetaDataUtils(), ctx->getModuleMetaData()));
             Passes2.add(new CodeGenContextWrapper(ctx));
+            Passes2.add(new WIAnalysisCacheWrapper(&wiCache, true));
             Passes2.add(createGenXFunctionGroupAnalysisPass());
             AddCodeGenPasses(*ctx, shaders, Passes2, pass2Mode, false);
             COMPILER_TIME_END(ctx, TIME_CG_Add_Passes);
@@ -4272,6 +4285,16 @@ namespace IGC
                     pCtx->SetSIMDInfo(SIMD_SKIP_HW, simdMode, ShaderDispatchMode::NOT_APPLICABLE);
                     return SIMDStatus::SIMD_PERF_FAIL;
                 }
+
+                // SIMD32 roughly doubles the register allocation working set.
+                // Skip it once a kernel of this compile used more than half of
+                // the memory budget.
+                uint32_t memBudgetKB = IGC_GET_FLAG_VALUE(CompileMemoryBudgetMB) * 1024;
+                if (memBudgetKB && pCtx->m_peakVISAMemoryKB * 2 > memBudgetKB)
+                {
+                    pCtx->SetSIMDInfo(SIMD_SKIP_PERF, simdMode, ShaderDispatchMode::NOT_APPLICABLE);
+                    return SIMDStatus::SIMD_PERF_FAIL;
+                }
             }
         }
 
@@ -79,6 +79,7 @@ namespace IGC
 
             bool replaceGlobalOffsetsByZero = false;
             bool IntelEnablePreRAScheduling = true;
+            bool IntelUseLinearScanRA = false;
             bool PromoteStatelessToBindless = false;
             bool PreferBindlessImages = false;
             bool UseBindlessMode = false;
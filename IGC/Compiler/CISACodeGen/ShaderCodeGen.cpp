@@ -14,6 +14,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/CISACodeGen/AdvCodeMotion.h"
 #include "Compiler/CISACodeGen/RematAddressArithmetic.h"
 #include "Compiler/CISACodeGen/AdvMemOpt.h"
+#include "Compiler/CISACodeGen/CrossBlockMemOpt.h"
 #include "Compiler/CISACodeGen/Emu64OpsPass.h"
 #include "Compiler/CISACodeGen/PullConstantHeuristics.hpp"
 #include "Compiler/CISACodeGen/PushAnalysis.hpp"
@@ -649,6 +650,10 @@ void AddLegalizationPasses(CodeGenContext& ctx, IGCPassManager& mpm, PSSignature
         if (IGC_IS_FLAG_ENABLED(EnableAdvMemOpt))
             mpm.add(createAdvMemOptPass());
 
+        // Bring loads and stores of neighbouring blocks together for MemOpt
+        if (IGC_IS_FLAG_ENABLED(EnableCrossBlockMemOpt))
+            mpm.add(createCrossBlockMemOptPass());
+
         bool AllowNegativeSymPtrsForLoad =
             ctx.type == ShaderType::OPENCL_SHADER;
 
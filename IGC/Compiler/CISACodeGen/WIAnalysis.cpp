@@ -56,6 +56,30 @@ WIAnalysis::WIAnalysis() : FunctionPass(ID)
     initializeWIAnalysisPass(*PassRegistry::getPassRegistry());
 }
 
+#undef PASS_FLAG
+#undef PASS_DESCRIPTION
+#undef PASS_CFG_ONLY
+#undef PASS_ANALYSIS
+#define PASS_FLAG "igc-wi-analysis-cache"
+#define PASS_DESCRIPTION "Shares WIAnalysis results across pass managers"
+#define PASS_CFG_ONLY true
+#define PASS_ANALYSIS true
+IGC_INITIALIZE_PASS_BEGIN(WIAnalysisCacheWrapper, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_END(WIAnalysisCacheWrapper, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+char WIAnalysisCacheWrapper::ID = 0;
+
+WIAnalysisCacheWrapper::WIAnalysisCacheWrapper() : ImmutablePass(ID)
+{
+    initializeWIAnalysisCacheWrapperPass(*PassRegistry::getPassRegistry());
+}
+
+WIAnalysisCacheWrapper::WIAnalysisCacheWrapper(WIAnalysisCache* cache, bool reuse)
+    : ImmutablePass(ID), m_cache(cache), m_reuse(reuse)
+{
+    initializeWIAnalysisCacheWrapperPass(*PassRegistry::getPassRegistry());
+}
+
 const unsigned int WIAnalysisRunner::MinIndexBitwidthToPreserve = 16;
 
 // For dumpping WIA info per each invocation
@@ -172,6 +196,35 @@ namespace IGC {
     };
 } // namespace IGC
 
+WIAnalysisRunner::WIAnalysisRunner() {}
+
+WIAnalysisRunner::WIAnalysisRunner(
+    llvm::Function* F,
+    llvm::DominatorTree* DT,
+    llvm::PostDominatorTree* PDT,
+    IGC::IGCMD::MetaDataUtils* MDUtils,
+    IGC::CodeGenContext* CGCtx,
+    IGC::ModuleMetaData* ModMD,
+    IGC::TranslationTable* TransTable)
+{
+    init(F, DT, PDT, MDUtils, CGCtx, ModMD, TransTable);
+}
+
+WIAnalysisRunner::~WIAnalysisRunner() {}
+
+void WIAnalysisRunner::releaseMemory()
+{
+    m_ctrlBranches.clear();
+    m_branchInfos.clear();
+    m_changed1.clear();
+    m_changed2.clear();
+    m_inChangedNew.clear();
+    m_allocaDepMap.clear();
+    m_storeDepMap.clear();
+    m_depMap.clear();
+    m_forcedUniforms.clear();
+}
+
 void WIAnalysisRunner::print(raw_ostream& OS, const Module*) const
 {
     DenseMap<BasicBlock*, int> BBIDs;
@@ -303,9 +356,11 @@ bool WIAnalysisRunner::run()
 
     m_changed1.clear();
     m_changed2.clear();
+    m_inChangedNew.clear();
     m_pChangedNew = &m_changed1;
     m_pChangedOld = &m_changed2;
     m_ctrlBranches.clear();
+    m_branchInfos.clear();
 
     m_storeDepMap.clear();
     m_allocaDepMap.clear();
@@ -330,6 +385,7 @@ bool WIAnalysisRunner::run()
         // This procedure is guranteed to converge since WI-dep can only
         // become less unifrom (uniform->consecutive->ptr->stride->random).
         updateDeps();
+        m_branchInfos.clear();
 
         // sweep the dataflow started from those GenISA_vectorUniform,
         // force all the insert-elements and phi-nodes to uniform
@@ -385,8 +441,33 @@ bool WIAnalysis::runOnFunction(Function& F)
     auto* ModMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
     auto* pTT = &getAnalysis<TranslationTable>();
 
-    Runner.init(&F, DT, PDT, MDUtils, CGCtx, ModMD, pTT);
-    return Runner.run();
+    auto* CacheWrapper = getAnalysisIfAvailable<WIAnalysisCacheWrapper>();
+    WIAnalysisCache* Cache = CacheWrapper ? CacheWrapper->getCache() : nullptr;
+    if (Cache && CacheWrapper->isReuse())
+    {
+        if (auto Cached = Cache->lookup(&F))
+        {
+            Runner = std::move(Cached);
+            Runner->rebind(pTT);
+            return false;
+        }
+    }
+
+    // A cache may still hold the previous result, so never reuse it in place.
+    Runner = std::make_shared<WIAnalysisRunner>();
+    Runner->init(&F, DT, PDT, MDUtils, CGCtx, ModMD, pTT);
+    bool Changed = Runner->run();
+    if (Cache && !CacheWrapper->isReuse())
+        Cache->insert(&F, Runner);
+    return Changed;
+}
+
+void WIAnalysisRunner::rebind(TranslationTable* TransTable)
+{
+    DT = nullptr;
+    PDT = nullptr;
+    m_TT = TransTable;
+    m_TT->RegisterListener(&m_depMap);
 }
 
 void WIAnalysisRunner::updateDeps()
@@ -399,6 +480,7 @@ void WIAnalysisRunner::updateDeps()
         // clear the newChanged set so it will be filled with the users of
         // instruction which their WI-dep canged during the current iteration
         m_pChangedNew->clear();
+        m_inChangedNew.clear();
 
         // update all changed values
         std::vector<const Value*>::iterator it = m_pChangedOld->begin();
@@ -554,47 +636,47 @@ void WIAnalysisRunner::updateArgsDependency(llvm::Function* pF)
 void WIAnalysis::print(
     llvm::raw_ostream& OS, const llvm::Module* M) const
 {
-    Runner.print(OS, M);
+    Runner->print(OS, M);
 }
 
 void WIAnalysis::dump() const
 {
-    Runner.dump();
+    Runner->dump();
 }
 
 void WIAnalysis::incUpdateDepend(const llvm::Value* val, WIDependancy dep)
 {
-    Runner.incUpdateDepend(val, dep);
+    Runner->incUpdateDepend(val, dep);
 }
 
 WIAnalysis::WIDependancy WIAnalysis::whichDepend(const llvm::Value* val)
 {
-    return Runner.whichDepend(val);
+    return Runner->whichDepend(val);
 }
 
 bool WIAnalysis::isUniform(const Value* val) const
 {
-    return Runner.isUniform(val);
+    return Runner->isUniform(val);
 }
 
 bool WIAnalysis::isGlobalUniform(const Value* val)
 {
-    return Runner.isGlobalUniform(val);
+    return Runner->isGlobalUniform(val);
 }
 
 bool WIAnalysis::isWorkGroupOrGlobalUniform(const Value* val)
 {
-    return Runner.isWorkGroupOrGlobalUniform(val);
+    return Runner->isWorkGroupOrGlobalUniform(val);
 }
 
 bool WIAnalysis::insideDivergentCF(const Value* val) const
 {
-    return Runner.insideDivergentCF(val);
+    return Runner->insideDivergentCF(val);
 }
 
 bool WIAnalysis::insideWorkgroupDivergentCF(const Value* val) const
 {
-    return Runner.insideWorkgroupDivergentCF(val);
+    return Runner->insideWorkgroupDivergentCF(val);
 }
 
 WIAnalysis::WIDependancy WIAnalysisRunner::whichDepend(const Value* val) const
@@ -903,12 +985,8 @@ void WIAnalysisRunner::update_cf_dep(const IGCLLVM::TerminatorInst* inst)
     IGC_ASSERT(hasDependency(inst));
     WIBaseClass::WIDependancy instDep = getDependency(inst);
 
-    BasicBlock* blk = (BasicBlock*)(inst->getParent());
-    BasicBlock* ipd = PDT->getNode(blk)->getIDom()->getBlock();
-    // a branch can have NULL immediate post-dominator when a function
-    // has multiple exits in llvm-ir
-    // compute influence region and the partial-joins
-    BranchInfo br_info(inst, ipd);
+    BranchInfo& br_info = *getBranchInfo(inst);
+    BasicBlock* ipd = const_cast<BasicBlock*>(br_info.full_join);
     // debug: dump influence region and partial-joins
     // br_info.print(ods());
 
@@ -952,7 +1030,7 @@ void WIAnalysisRunner::update_cf_dep(const IGCLLVM::TerminatorInst* inst)
                 // because it might need to be RANDOM.
                 auto it = m_storeDepMap.find(st);
                 if (it != m_storeDepMap.end())
-                    m_pChangedNew->push_back(it->second);
+                    markChanged(it->second);
             }
 
             // This is an optimization that tries to detect instruction
@@ -1005,6 +1083,21 @@ void WIAnalysisRunner::update_cf_dep(const IGCLLVM::TerminatorInst* inst)
     } // end of influence-region block loop
 }
 
+BranchInfo* WIAnalysisRunner::getBranchInfo(const IGCLLVM::TerminatorInst* inst)
+{
+    auto& BI = m_branchInfos[inst];
+    if (!BI)
+    {
+        BasicBlock* blk = (BasicBlock*)(inst->getParent());
+        BasicBlock* ipd = PDT->getNode(blk)->getIDom()->getBlock();
+        // a branch can have NULL immediate post-dominator when a function
+        // has multiple exits in llvm-ir
+        // compute influence region and the partial-joins
+        BI = std::make_unique<BranchInfo>(inst, ipd);
+    }
+    return BI.get();
+}
+
 void WIAnalysisRunner::updatePHIDepAtJoin(BasicBlock* blk, BranchInfo* brInfo)
 {
     // This is to bring down PHI's dep to br's dep.
@@ -1069,14 +1162,14 @@ void WIAnalysisRunner::updateDepMap(const Instruction* inst, WIAnalysis::WIDepen
     Value::const_user_iterator e = inst->user_end();
     for (; it != e; ++it)
     {
-        m_pChangedNew->push_back(*it);
+        markChanged(*it);
     }
     if (const StoreInst * st = dyn_cast<StoreInst>(inst))
     {
         auto it = m_storeDepMap.find(st);
         if (it != m_storeDepMap.end())
         {
-            m_pChangedNew->push_back(it->second);
+            markChanged(it->second);
         }
     }
 
@@ -1114,7 +1207,7 @@ void WIAnalysisRunner::updateInsertElements(const InsertElementInst* inst)
         Value::user_iterator e = curInst->user_end();
         for (; it != e; ++it)
         {
-            m_pChangedNew->push_back(*it);
+            markChanged(*it);
         }
     }
 }
@@ -1147,7 +1240,7 @@ void WIAnalysisRunner::updateInsertValues(const InsertValueInst* Inst)
         auto e = pI->user_end();
         for (; it != e; ++it)
         {
-            m_pChangedNew->push_back(*it);
+            markChanged(*it);
         }
     }
 }
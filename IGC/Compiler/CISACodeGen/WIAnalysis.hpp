@@ -38,6 +38,7 @@ SPDX-License-Identifier: MIT
 #endif
 
 #include <vector>
+#include <memory>
 #include <common/Types.hpp>
 
 namespace IGC
@@ -92,16 +93,18 @@ namespace IGC
             IGCMD::MetaDataUtils* MDUtils,
             CodeGenContext* CGCtx,
             ModuleMetaData* ModMD,
-            TranslationTable* TransTable)
-        {
-            init(F, DT, PDT, MDUtils, CGCtx, ModMD, TransTable);
-        }
+            TranslationTable* TransTable);
 
-        WIAnalysisRunner() {}
-        ~WIAnalysisRunner() {}
+        WIAnalysisRunner();
+        ~WIAnalysisRunner();
 
         bool run();
 
+        /// @brief Re-attach a previously computed result to the analyses of
+        /// the pass manager that is about to use it. Dominator trees are only
+        /// needed while running, so they are dropped rather than kept stale.
+        void rebind(TranslationTable* TransTable);
+
         /// @brief Returns the type of dependency the instruction has on
         /// the work-item
         /// @param val llvm::Value to test
@@ -133,16 +136,7 @@ namespace IGC
         /// of only global and workgroup uniform branches.
         bool insideWorkgroupDivergentCF(const llvm::Value* val) const;
 
-        void releaseMemory()
-        {
-            m_ctrlBranches.clear();
-            m_changed1.clear();
-            m_changed2.clear();
-            m_allocaDepMap.clear();
-            m_storeDepMap.clear();
-            m_depMap.clear();
-            m_forcedUniforms.clear();
-        }
+        void releaseMemory();
 
         /// print - print m_deps in human readable form
         void print(llvm::raw_ostream& OS, const llvm::Module* = 0) const;
@@ -166,6 +160,19 @@ namespace IGC
         /// @brief Update dependency relations between all values
         void updateDeps();
 
+        /// @brief Queue a value for re-evaluation in the next round of
+        ///        updateDeps. A value is queued at most once per round.
+        void markChanged(const llvm::Value* val)
+        {
+            if (m_inChangedNew.insert(val).second)
+                m_pChangedNew->push_back(val);
+        }
+
+        /// @brief Return the influence region of a divergent branch. It only
+        ///        depends on the CFG, so it is computed once per branch even if
+        ///        the dependency of the branch is lowered several times.
+        BranchInfo* getBranchInfo(const IGCLLVM::TerminatorInst* inst);
+
         /// @brief mark the arguments dependency based on the metadata set
         void updateArgsDependency(llvm::Function* pF);
 
@@ -273,6 +280,12 @@ namespace IGC
         /// ptr to m_changed1, m_changed2
         std::vector<const llvm::Value*>* m_pChangedOld;
         std::vector<const llvm::Value*>* m_pChangedNew;
+        /// values currently in *m_pChangedNew
+        llvm::DenseSet<const llvm::Value*> m_inChangedNew;
+
+        /// influence region and partial joins of every divergent branch seen
+        /// so far; only valid while run() is in progress.
+        llvm::DenseMap<const llvm::Instruction*, std::unique_ptr<BranchInfo>> m_branchInfos;
 
         /// <summary>
         ///  hold the vector-defs that are promoted from an uniform alloca
@@ -373,7 +386,8 @@ namespace IGC
 
         void releaseMemory() override
         {
-            Runner.releaseMemory();
+            // The result may still be referenced by a WIAnalysisCache.
+            Runner.reset();
         }
 
 
@@ -384,7 +398,57 @@ namespace IGC
                 Dep == WIDependancy::UNIFORM_THREAD;
         }
     private:
-        WIAnalysisRunner Runner;
+        std::shared_ptr<WIAnalysisRunner> Runner;
+    };
+
+    /// @brief Keeps WIAnalysis results alive across pass managers.
+    /// Work-item dependency does not depend on the dispatch SIMD width, so
+    /// when codegen for several SIMD modes is split over separate pass
+    /// managers, the later ones can reuse what the first one computed.
+    class WIAnalysisCache
+    {
+    public:
+        std::shared_ptr<WIAnalysisRunner> lookup(const llvm::Function* F) const
+        {
+            auto It = m_results.find(F);
+            return It != m_results.end() ? It->second : nullptr;
+        }
+
+        void insert(const llvm::Function* F, std::shared_ptr<WIAnalysisRunner> R)
+        {
+            m_results[F] = std::move(R);
+        }
+
+        void clear() { m_results.clear(); }
+
+    private:
+        llvm::DenseMap<const llvm::Function*, std::shared_ptr<WIAnalysisRunner>> m_results;
+    };
+
+    /// @brief Immutable pass exposing a WIAnalysisCache owned by the caller.
+    /// In record mode every WIAnalysis result is stored in the cache (a later
+    /// run for the same function overwrites the earlier one); in reuse mode
+    /// WIAnalysis takes the cached result instead of recomputing it. The IR
+    /// must not change between the recording and the reusing pass manager.
+    class WIAnalysisCacheWrapper : public llvm::ImmutablePass
+    {
+    public:
+        static char ID;
+
+        WIAnalysisCacheWrapper();
+        WIAnalysisCacheWrapper(WIAnalysisCache* cache, bool reuse);
+
+        llvm::StringRef getPassName() const override
+        {
+            return "WIAnalysisCacheWrapper";
+        }
+
+        WIAnalysisCache* getCache() const { return m_cache; }
+        bool isReuse() const { return m_reuse; }
+
+    private:
+        WIAnalysisCache* m_cache = nullptr;
+        bool m_reuse = false;
     };
 
 } // namespace IGC
@@ -894,6 +894,10 @@ namespace IGC
 
         RetryManager m_retryManager;
 
+        // Highest vISA memory peak (in KB) of the shaders compiled so far,
+        // checked against the CompileMemoryBudgetMB budget.
+        uint32_t m_peakVISAMemoryKB = 0;
+
         IGCMetrics::IGCMetric metrics;
 
         // shader stat for opt customization
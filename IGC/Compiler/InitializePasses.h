@@ -189,6 +189,7 @@ void initializeVectorProcessPass(llvm::PassRegistry&);
 void initializeVerificationPassPass(llvm::PassRegistry&);
 void initializeWGFuncResolutionPass(llvm::PassRegistry&);
 void initializeWIAnalysisPass(llvm::PassRegistry&);
+void initializeWIAnalysisCacheWrapperPass(llvm::PassRegistry&);
 void initializeWIFuncResolutionPass(llvm::PassRegistry&);
 void initializeWIFuncsAnalysisPass(llvm::PassRegistry&);
 void initializeWorkaroundAnalysisPass(llvm::PassRegistry&);
@@ -201,6 +202,7 @@ void initializeLoopCanonicalizationPass(llvm::PassRegistry&);
 void initializeLoopHoistConstantPass(llvm::PassRegistry&);
 void initializeDisableLICMForSpecificLoopsPass(llvm::PassRegistry&);
 void initializeMemOptPass(llvm::PassRegistry&);
+void initializeCrossBlockMemOptPass(llvm::PassRegistry&);
 void initializePreRASchedulerPass(llvm::PassRegistry&);
 void initializeBIFTransformsPass(llvm::PassRegistry&);
 void initializeThreadCombiningPass(llvm::PassRegistry&);
@@ -645,7 +645,6 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
 
     for (int i = 0; i < NUM_LIBMODS; ++i) {
         m_libModuleToBeImported[i] = false;
-        m_libModuleAlreadyImported[i] = false;
     }
     m_allNewCallInsts.clear();
 
@@ -680,16 +679,14 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
                     continue;
                 }
 
-                if (m_libModuleAlreadyImported[i])
-                    continue;
-
                 const char* pLibraryModule = (const char*)m_libModInfos[i].Mod;
                 uint32_t libSize = m_libModInfos[i].ModSize;
 
-                // Load the module we want to compile and link it to existing module
+                // Load the library lazily, directly over the embedded array,
+                // so only the functions that get linked are materialized.
                 StringRef BitRef(pLibraryModule, libSize);
                 llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-                    llvm::parseBitcodeFile(MemoryBufferRef(BitRef.str(), ""), M.getContext());
+                    llvm::getLazyBitcodeModule(MemoryBufferRef(BitRef, ""), M.getContext());
                 if (llvm::Error EC = ModuleOrErr.takeError())
                 {
                     IGC_ASSERT_MESSAGE(0, "llvm getLazyBitcodeModule - FAILED to parse bitcode");
@@ -697,18 +694,26 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
                 std::unique_ptr<llvm::Module> m_pBuiltinModule = std::move(*ModuleOrErr);
                 IGC_ASSERT_MESSAGE(m_pBuiltinModule, "llvm version mismatch - could not load llvm module");
 
+                // Module flags must be loaded before they can be removed below.
+                if (llvm::Error EC = m_pBuiltinModule->materializeMetadata())
+                {
+                    IGC_ASSERT_MESSAGE(0, "llvm materializeMetadata - FAILED to load metadata");
+                }
+
                 // Set target triple and datalayout to the original module (emulation func
                 // works for both 64 & 32 bit applications).
                 m_pBuiltinModule->setDataLayout(M.getDataLayout());
                 m_pBuiltinModule->setTargetTriple(M.getTargetTriple());
                 removeLLVMModuleFlag(m_pBuiltinModule.get());
 
-                // Linking the two modules
-                if (ld.linkInModule(std::move(m_pBuiltinModule)))
+                // Link only the functions declared in M and what they reference.
+                // Functions already linked in by the first visit are defined in
+                // M and are skipped, so the same library can be linked again
+                // when the second visit needs more of it.
+                if (ld.linkInModule(std::move(m_pBuiltinModule), Linker::LinkOnlyNeeded))
                 {
                     IGC_ASSERT_MESSAGE(0, "Error linking the two modules");
                 }
-                m_libModuleAlreadyImported[i] = true;
                 m_pBuiltinModule = nullptr;
             }
         }
@@ -237,7 +237,6 @@ namespace IGC
         bool isDPConvFunc(llvm::Function* F) const;
 
         bool m_libModuleToBeImported[NUM_LIBMODS];
-        bool m_libModuleAlreadyImported[NUM_LIBMODS];
 
         bool Int32DivRemEmuRemaining = true;
 
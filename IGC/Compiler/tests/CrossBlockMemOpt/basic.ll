@@ -0,0 +1,124 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2023 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+;
+; RUN: igc_opt %s -S -o - %enable-basic-aa% -igc-crossblock-memopt | FileCheck %s
+; ------------------------------------------------
+; CrossBlockMemOpt
+; ------------------------------------------------
+
+; Identical loads of both arms are merged into the branching block.
+define void @merge_arms(i1 %c, i32 addrspace(1)* %p, i32 addrspace(1)* %q) {
+; CHECK-LABEL: @merge_arms(
+; CHECK:  entry:
+; CHECK:    [[A:%[A-z0-9]*]] = load i32, i32 addrspace(1)* %p, align 4
+; CHECK:    br i1 %c
+; CHECK:  then:
+; CHECK-NOT: load
+; CHECK:    store i32 [[A]], i32 addrspace(1)* %q
+; CHECK:  else:
+; CHECK-NOT: load
+; CHECK:    add i32 [[A]], 1
+entry:
+  br i1 %c, label %then, label %else
+
+then:
+  %a = load i32, i32 addrspace(1)* %p, align 4
+  store i32 %a, i32 addrspace(1)* %q, align 4
+  br label %end
+
+else:
+  %b = load i32, i32 addrspace(1)* %p, align 4
+  %b1 = add i32 %b, 1
+  store i32 %b1, i32 addrspace(1)* %q, align 4
+  br label %end
+
+end:
+  ret void
+}
+
+; The load of the join block is hoisted next to the one of the dominator.
+define void @hoist_load(i1 %c, i32 addrspace(1)* noalias %p, i32 addrspace(1)* noalias %q, i32 %v) {
+; CHECK-LABEL: @hoist_load(
+; CHECK:  entry:
+; CHECK:    [[A:%[A-z0-9]*]] = load i32, i32 addrspace(1)* %p, align 4
+; CHECK:    [[P1:%[A-z0-9]*]] = getelementptr inbounds i32, i32 addrspace(1)* %p, i64 1
+; CHECK:    [[B:%[A-z0-9]*]] = load i32, i32 addrspace(1)* [[P1]], align 4
+; CHECK:    br i1 %c
+; CHECK:  join:
+; CHECK-NOT: load
+; CHECK:    add i32 [[A]], [[B]]
+entry:
+  %a = load i32, i32 addrspace(1)* %p, align 4
+  br i1 %c, label %if, label %join
+
+if:
+  store i32 %v, i32 addrspace(1)* %q, align 4
+  br label %join
+
+join:
+  %p1 = getelementptr inbounds i32, i32 addrspace(1)* %p, i64 1
+  %b = load i32, i32 addrspace(1)* %p1, align 4
+  %s = add i32 %a, %b
+  store i32 %s, i32 addrspace(1)* %q, align 4
+  ret void
+}
+
+; The store in between may write the loaded location.
+define void @no_hoist_load(i1 %c, i32 addrspace(1)* %p, i32 addrspace(1)* %q, i32 %v) {
+; CHECK-LABEL: @no_hoist_load(
+; CHECK:  join:
+; CHECK:    getelementptr
+; CHECK:    load i32
+entry:
+  %a = load i32, i32 addrspace(1)* %p, align 4
+  br i1 %c, label %if, label %join
+
+if:
+  store i32 %v, i32 addrspace(1)* %q, align 4
+  br label %join
+
+join:
+  %p1 = getelementptr inbounds i32, i32 addrspace(1)* %p, i64 1
+  %b = load i32, i32 addrspace(1)* %p1, align 4
+  %s = add i32 %a, %b
+  store i32 %s, i32 addrspace(1)* %q, align 4
+  ret void
+}
+
+; The store of the dominator is sunk next to the one of the join block.
+define void @sink_store(i1 %c, i32 addrspace(1)* noalias %p, i32 addrspace(1)* noalias %q, i32 %x, i32 %y) {
+; CHECK-LABEL: @sink_store(
+; CHECK:  entry:
+; CHECK-NOT: store
+; CHECK:    br i1 %c
+; CHECK:  join:
+; CHECK:    store i32 %x, i32 addrspace(1)* %q, align 4
+; CHECK:    store i32 {{%[A-z0-9]*}}, i32 addrspace(1)* {{%[A-z0-9]*}}, align 4
+entry:
+  store i32 %x, i32 addrspace(1)* %q, align 4
+  br i1 %c, label %if, label %join
+
+if:
+  %l = load i32, i32 addrspace(1)* %p, align 4
+  store i32 %l, i32 addrspace(1)* %p, align 4
+  br label %join
+
+join:
+  %q1 = getelementptr inbounds i32, i32 addrspace(1)* %q, i64 1
+  store i32 %y, i32 addrspace(1)* %q1, align 4
+  ret void
+}
+
+!igc.functions = !{!0, !3, !4, !5}
+
+!0 = !{void (i1, i32 addrspace(1)*, i32 addrspace(1)*)* @merge_arms, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+!3 = !{void (i1, i32 addrspace(1)*, i32 addrspace(1)*, i32)* @hoist_load, !1}
+!4 = !{void (i1, i32 addrspace(1)*, i32 addrspace(1)*, i32)* @no_hoist_load, !1}
+!5 = !{void (i1, i32 addrspace(1)*, i32 addrspace(1)*, i32, i32)* @sink_store, !1}
@@ -0,0 +1,94 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2023 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+;
+; RUN: igc_opt --regkey PrintToConsole --regkey PrintCrossBlockMemOptStats %s -S -o - %enable-basic-aa% -igc-crossblock-memopt -igc-memopt 2>&1 | FileCheck %s
+; ------------------------------------------------
+; CrossBlockMemOpt: messages eliminated
+; ------------------------------------------------
+
+; Merging the loads of both arms leaves one load message.
+; CHECK: CrossBlockMemOpt: merge_arms: memory messages eliminated: 1
+define void @merge_arms(i1 %c, i32 addrspace(1)* %p, i32 addrspace(1)* %q) {
+entry:
+  br i1 %c, label %then, label %else
+
+then:
+  %a = load i32, i32 addrspace(1)* %p, align 4
+  store i32 %a, i32 addrspace(1)* %q, align 4
+  br label %end
+
+else:
+  %b = load i32, i32 addrspace(1)* %p, align 4
+  %b1 = add i32 %b, 1
+  store i32 %b1, i32 addrspace(1)* %q, align 4
+  br label %end
+
+end:
+  ret void
+}
+
+; MemOpt merges the hoisted load with the one of the dominator.
+; CHECK: CrossBlockMemOpt: hoist_load: memory messages eliminated: 1
+define void @hoist_load(i1 %c, i32 addrspace(1)* noalias %p, i32 addrspace(1)* noalias %q, i32 %v) {
+entry:
+  %a = load i32, i32 addrspace(1)* %p, align 4
+  br i1 %c, label %if, label %join
+
+if:
+  store i32 %v, i32 addrspace(1)* %q, align 4
+  br label %join
+
+join:
+  %p1 = getelementptr inbounds i32, i32 addrspace(1)* %p, i64 1
+  %b = load i32, i32 addrspace(1)* %p1, align 4
+  %s = add i32 %a, %b
+  store i32 %s, i32 addrspace(1)* %q, align 4
+  ret void
+}
+
+; Nothing is moved, so nothing is reported even though MemOpt merges.
+; CHECK-NOT: CrossBlockMemOpt: same_block
+define void @same_block(i32 addrspace(1)* %p, i32 addrspace(1)* %q) {
+entry:
+  %a = load i32, i32 addrspace(1)* %p, align 4
+  %p1 = getelementptr inbounds i32, i32 addrspace(1)* %p, i64 1
+  %b = load i32, i32 addrspace(1)* %p1, align 4
+  %s = add i32 %a, %b
+  store i32 %s, i32 addrspace(1)* %q, align 4
+  ret void
+}
+
+; MemOpt merges the sunk store with the one of the join block.
+; CHECK: CrossBlockMemOpt: sink_store: memory messages eliminated: 1
+define void @sink_store(i1 %c, i32 addrspace(1)* noalias %p, i32 addrspace(1)* noalias %q, i32 %x, i32 %y) {
+entry:
+  store i32 %x, i32 addrspace(1)* %q, align 4
+  br i1 %c, label %if, label %join
+
+if:
+  %l = load i32, i32 addrspace(1)* %p, align 4
+  store i32 %l, i32 addrspace(1)* %p, align 4
+  br label %join
+
+join:
+  %q1 = getelementptr inbounds i32, i32 addrspace(1)* %q, i64 1
+  store i32 %y, i32 addrspace(1)* %q1, align 4
+  ret void
+}
+
+; The tags used for counting are removed.
+; CHECK-NOT: igc.crossblock.memopt
+
+!igc.functions = !{!0, !3, !4, !5}
+
+!0 = !{void (i1, i32 addrspace(1)*, i32 addrspace(1)*)* @merge_arms, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+!3 = !{void (i1, i32 addrspace(1)*, i32 addrspace(1)*, i32)* @hoist_load, !1}
+!4 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @same_block, !1}
+!5 = !{void (i1, i32 addrspace(1)*, i32 addrspace(1)*, i32, i32)* @sink_store, !1}
@@ -0,0 +1,333 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2023 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+;
+; RUN: igc_opt --regkey PrintToConsole -igc-wi-analysis -print-wia-check -S < %s 2>&1 | FileCheck %s
+; ------------------------------------------------
+; WIAnalysis
+; ------------------------------------------------
+
+; 32 levels of divergent branches nested in each other. The influence region
+; of every branch contains all the inner ones, and each join phi changes once
+; per level, so this stresses the worklist and the influence region cache.
+; Values computed from uniform operands stay uniform, values merged at a join
+; of a divergent branch become random.
+
+; CHECK-LABEL: WIAnalysis: nested_divergence
+; CHECK: random {{.*}}%c0 = icmp
+; CHECK: uniform_{{[a-z]+}} {{.*}}%a1 = add
+; CHECK: random {{.*}}%c1 = icmp
+; CHECK: uniform_{{[a-z]+}} {{.*}}%a32 = add
+; CHECK: random {{.*}}%p31 = phi
+; CHECK: random {{.*}}%p1 = phi
+; CHECK: random {{.*}}%p0 = phi
+define void @nested_divergence(i32 %n, i32 addrspace(1)* %out) {
+entry:
+  %lid = call i16 @llvm.genx.GenISA.getLocalID.X()
+  %lid32 = zext i16 %lid to i32
+  br label %l0
+
+l0:
+  %c0 = icmp ult i32 %lid32, %n
+  br i1 %c0, label %l1, label %j0
+
+l1:
+  %a1 = add i32 %n, 1
+  %c1 = icmp ult i32 %lid32, %a1
+  br i1 %c1, label %l2, label %j1
+
+l2:
+  %a2 = add i32 %n, 2
+  %c2 = icmp ult i32 %lid32, %a2
+  br i1 %c2, label %l3, label %j2
+
+l3:
+  %a3 = add i32 %n, 3
+  %c3 = icmp ult i32 %lid32, %a3
+  br i1 %c3, label %l4, label %j3
+
+l4:
+  %a4 = add i32 %n, 4
+  %c4 = icmp ult i32 %lid32, %a4
+  br i1 %c4, label %l5, label %j4
+
+l5:
+  %a5 = add i32 %n, 5
+  %c5 = icmp ult i32 %lid32, %a5
+  br i1 %c5, label %l6, label %j5
+
+l6:
+  %a6 = add i32 %n, 6
+  %c6 = icmp ult i32 %lid32, %a6
+  br i1 %c6, label %l7, label %j6
+
+l7:
+  %a7 = add i32 %n, 7
+  %c7 = icmp ult i32 %lid32, %a7
+  br i1 %c7, label %l8, label %j7
+
+l8:
+  %a8 = add i32 %n, 8
+  %c8 = icmp ult i32 %lid32, %a8
+  br i1 %c8, label %l9, label %j8
+
+l9:
+  %a9 = add i32 %n, 9
+  %c9 = icmp ult i32 %lid32, %a9
+  br i1 %c9, label %l10, label %j9
+
+l10:
+  %a10 = add i32 %n, 10
+  %c10 = icmp ult i32 %lid32, %a10
+  br i1 %c10, label %l11, label %j10
+
+l11:
+  %a11 = add i32 %n, 11
+  %c11 = icmp ult i32 %lid32, %a11
+  br i1 %c11, label %l12, label %j11
+
+l12:
+  %a12 = add i32 %n, 12
+  %c12 = icmp ult i32 %lid32, %a12
+  br i1 %c12, label %l13, label %j12
+
+l13:
+  %a13 = add i32 %n, 13
+  %c13 = icmp ult i32 %lid32, %a13
+  br i1 %c13, label %l14, label %j13
+
+l14:
+  %a14 = add i32 %n, 14
+  %c14 = icmp ult i32 %lid32, %a14
+  br i1 %c14, label %l15, label %j14
+
+l15:
+  %a15 = add i32 %n, 15
+  %c15 = icmp ult i32 %lid32, %a15
+  br i1 %c15, label %l16, label %j15
+
+l16:
+  %a16 = add i32 %n, 16
+  %c16 = icmp ult i32 %lid32, %a16
+  br i1 %c16, label %l17, label %j16
+
+l17:
+  %a17 = add i32 %n, 17
+  %c17 = icmp ult i32 %lid32, %a17
+  br i1 %c17, label %l18, label %j17
+
+l18:
+  %a18 = add i32 %n, 18
+  %c18 = icmp ult i32 %lid32, %a18
+  br i1 %c18, label %l19, label %j18
+
+l19:
+  %a19 = add i32 %n, 19
+  %c19 = icmp ult i32 %lid32, %a19
+  br i1 %c19, label %l20, label %j19
+
+l20:
+  %a20 = add i32 %n, 20
+  %c20 = icmp ult i32 %lid32, %a20
+  br i1 %c20, label %l21, label %j20
+
+l21:
+  %a21 = add i32 %n, 21
+  %c21 = icmp ult i32 %lid32, %a21
+  br i1 %c21, label %l22, label %j21
+
+l22:
+  %a22 = add i32 %n, 22
+  %c22 = icmp ult i32 %lid32, %a22
+  br i1 %c22, label %l23, label %j22
+
+l23:
+  %a23 = add i32 %n, 23
+  %c23 = icmp ult i32 %lid32, %a23
+  br i1 %c23, label %l24, label %j23
+
+l24:
+  %a24 = add i32 %n, 24
+  %c24 = icmp ult i32 %lid32, %a24
+  br i1 %c24, label %l25, label %j24
+
+l25:
+  %a25 = add i32 %n, 25
+  %c25 = icmp ult i32 %lid32, %a25
+  br i1 %c25, label %l26, label %j25
+
+l26:
+  %a26 = add i32 %n, 26
+  %c26 = icmp ult i32 %lid32, %a26
+  br i1 %c26, label %l27, label %j26
+
+l27:
+  %a27 = add i32 %n, 27
+  %c27 = icmp ult i32 %lid32, %a27
+  br i1 %c27, label %l28, label %j27
+
+l28:
+  %a28 = add i32 %n, 28
+  %c28 = icmp ult i32 %lid32, %a28
+  br i1 %c28, label %l29, label %j28
+
+l29:
+  %a29 = add i32 %n, 29
+  %c29 = icmp ult i32 %lid32, %a29
+  br i1 %c29, label %l30, label %j29
+
+l30:
+  %a30 = add i32 %n, 30
+  %c30 = icmp ult i32 %lid32, %a30
+  br i1 %c30, label %l31, label %j30
+
+l31:
+  %a31 = add i32 %n, 31
+  %c31 = icmp ult i32 %lid32, %a31
+  br i1 %c31, label %l32, label %j31
+
+l32:
+  %a32 = add i32 %n, 32
+  br label %j31
+
+j31:
+  %p31 = phi i32 [ %a32, %l32 ], [ %a31, %l31 ]
+  br label %j30
+
+j30:
+  %p30 = phi i32 [ %p31, %j31 ], [ %a30, %l30 ]
+  br label %j29
+
+j29:
+  %p29 = phi i32 [ %p30, %j30 ], [ %a29, %l29 ]
+  br label %j28
+
+j28:
+  %p28 = phi i32 [ %p29, %j29 ], [ %a28, %l28 ]
+  br label %j27
+
+j27:
+  %p27 = phi i32 [ %p28, %j28 ], [ %a27, %l27 ]
+  br label %j26
+
+j26:
+  %p26 = phi i32 [ %p27, %j27 ], [ %a26, %l26 ]
+  br label %j25
+
+j25:
+  %p25 = phi i32 [ %p26, %j26 ], [ %a25, %l25 ]
+  br label %j24
+
+j24:
+  %p24 = phi i32 [ %p25, %j25 ], [ %a24, %l24 ]
+  br label %j23
+
+j23:
+  %p23 = phi i32 [ %p24, %j24 ], [ %a23, %l23 ]
+  br label %j22
+
+j22:
+  %p22 = phi i32 [ %p23, %j23 ], [ %a22, %l22 ]
+  br label %j21
+
+j21:
+  %p21 = phi i32 [ %p22, %j22 ], [ %a21, %l21 ]
+  br label %j20
+
+j20:
+  %p20 = phi i32 [ %p21, %j21 ], [ %a20, %l20 ]
+  br label %j19
+
+j19:
+  %p19 = phi i32 [ %p20, %j20 ], [ %a19, %l19 ]
+  br label %j18
+
+j18:
+  %p18 = phi i32 [ %p19, %j19 ], [ %a18, %l18 ]
+  br label %j17
+
+j17:
+  %p17 = phi i32 [ %p18, %j18 ], [ %a17, %l17 ]
+  br label %j16
+
+j16:
+  %p16 = phi i32 [ %p17, %j17 ], [ %a16, %l16 ]
+  br label %j15
+
+j15:
+  %p15 = phi i32 [ %p16, %j16 ], [ %a15, %l15 ]
+  br label %j14
+
+j14:
+  %p14 = phi i32 [ %p15, %j15 ], [ %a14, %l14 ]
+  br label %j13
+
+j13:
+  %p13 = phi i32 [ %p14, %j14 ], [ %a13, %l13 ]
+  br label %j12
+
+j12:
+  %p12 = phi i32 [ %p13, %j13 ], [ %a12, %l12 ]
+  br label %j11
+
+j11:
+  %p11 = phi i32 [ %p12, %j12 ], [ %a11, %l11 ]
+  br label %j10
+
+j10:
+  %p10 = phi i32 [ %p11, %j11 ], [ %a10, %l10 ]
+  br label %j9
+
+j9:
+  %p9 = phi i32 [ %p10, %j10 ], [ %a9, %l9 ]
+  br label %j8
+
+j8:
+  %p8 = phi i32 [ %p9, %j9 ], [ %a8, %l8 ]
+  br label %j7
+
+j7:
+  %p7 = phi i32 [ %p8, %j8 ], [ %a7, %l7 ]
+  br label %j6
+
+j6:
+  %p6 = phi i32 [ %p7, %j7 ], [ %a6, %l6 ]
+  br label %j5
+
+j5:
+  %p5 = phi i32 [ %p6, %j6 ], [ %a5, %l5 ]
+  br label %j4
+
+j4:
+  %p4 = phi i32 [ %p5, %j5 ], [ %a4, %l4 ]
+  br label %j3
+
+j3:
+  %p3 = phi i32 [ %p4, %j4 ], [ %a3, %l3 ]
+  br label %j2
+
+j2:
+  %p2 = phi i32 [ %p3, %j3 ], [ %a2, %l2 ]
+  br label %j1
+
+j1:
+  %p1 = phi i32 [ %p2, %j2 ], [ %a1, %l1 ]
+  br label %j0
+
+j0:
+  %p0 = phi i32 [ %p1, %j1 ], [ %n, %l0 ]
+  store i32 %p0, i32 addrspace(1)* %out, align 4
+  ret void
+}
+
+declare i16 @llvm.genx.GenISA.getLocalID.X()
+
+!igc.functions = !{!0}
+
+!0 = !{void (i32, i32 addrspace(1)*)* @nested_divergence, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
@@ -320,6 +320,21 @@ void CompileUnit::addSInt(IGC::DIEBlock *Die, Optional<dwarf::Form> Form,
 /// table.
 void CompileUnit::addString(DIE *Die, dwarf::Attribute Attribute,
                             StringRef String) {
+  if (EmitSettings.UseStringPool) {
+    // Reference the string from .debug_str. The section is mergeable, so
+    // identical strings coming from different kernels are folded together
+    // once the per-kernel ELF files are linked.
+    MCSymbol *Symb = DD->getStringPoolEntry(String);
+    DIEValue *Value = nullptr;
+    if (EmitSettings.EnableRelocation)
+      Value = new (DIEValueAllocator) DIELabel(Symb);
+    else
+      Value = new (DIEValueAllocator) DIEDelta(Symb, DD->getStringPoolSym());
+    DIEValue *Str = new (DIEValueAllocator) DIEString(Value, String);
+    Die->addValue(Attribute, dwarf::DW_FORM_strp, Str);
+    return;
+  }
+
   // Emit string inlined
   auto Str = new (DIEValueAllocator) DIEInlinedString(String);
   // Collect all inlined string DIEs to later call dtor
@@ -22,6 +22,7 @@ struct DebugEmitterOpts {
   bool ScratchOffsetInOW = true;
   bool EmitATLinkageName = true;
   bool EnableDebugInfoValidation = false;
+  bool UseStringPool = false;
 };
 } // namespace IGC
 
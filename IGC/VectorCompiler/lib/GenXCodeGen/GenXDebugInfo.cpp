@@ -228,6 +228,9 @@ static cl::opt<bool>
     DbgOpt_ZeBinCompatible("vc-experimental-dbg-info-zebin-compatible",
                            cl::init(false), cl::Hidden,
                            cl::desc("same as IGC_ZeBinCompatibleDebugging"));
+static cl::opt<bool>
+    DbgOpt_StringPool("vc-dbginfo-string-pool", cl::init(false), cl::Hidden,
+                      cl::desc("same as IGC_DebugInfoStringPool"));
 
 static cl::opt<std::string> DbgOpt_VisaTransformInfoPath(
     "vc-dump-module-to-visa-transform-info-path", cl::init(""), cl::Hidden,
@@ -1556,6 +1559,9 @@ static void fillDbgInfoOptions(const GenXBackendConfig &BC,
   if (BC.enableDebugInfoValidation() || DbgOpt_ValidationEnable) {
     DebugOpts.EnableDebugInfoValidation = true;
   }
+  if (DbgOpt_StringPool) {
+    DebugOpts.UseStringPool = true;
+  }
 }
 
 bool GenXDebugInfo::runOnModule(Module &M) {
@@ -33,6 +33,7 @@ SPDX-License-Identifier: MIT
 #include "llvmWrapper/IR/InstrTypes.h"
 #include "llvmWrapper/IR/Instructions.h"
 
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/CodeGen/TargetPassConfig.h"
 #include "llvm/IR/BasicBlock.h"
@@ -76,14 +77,12 @@ bool GenXLiveness::runOnFunctionGroup(FunctionGroup &ArgFG)
  */
 void GenXLiveness::releaseMemory() {
   LLVM_DEBUG(dbgs() << "releaseMemory for GenXLivness\n");
-  while (!LiveRangeMap.empty()) {
-    LiveRange *LR = begin()->second;
-    for (auto i = LR->value_begin(), e = LR->value_end(); i != e; ++i) {
-      SimpleValue V = *i;
-      LiveRangeMap.erase(V);
-    }
-    delete LR;
-  }
+  // Several values share one LiveRange, delete each of them once.
+  SmallPtrSet<LiveRange *, 32> LRs;
+  for (auto &Entry : LiveRangeMap)
+    if (LRs.insert(Entry.second).second)
+      delete Entry.second;
+  LiveRangeMap.clear();
   FG = 0;
   CG.reset();
   for (auto i = UnifiedRets.begin(), e = UnifiedRets.end(); i != e; ++i)
@@ -623,7 +622,7 @@ void GenXLiveness::replaceValue(SimpleValue OldVal, SimpleValue NewVal)
  */
 LiveRange *GenXLiveness::getOrCreateLiveRange(SimpleValue V)
 {
-  auto [i, isInserted] = LiveRangeMap.emplace(V, nullptr);
+  auto [i, isInserted] = LiveRangeMap.try_emplace(V, nullptr);
   LLVM_DEBUG(dbgs() << "getOrCreateLiveRange for SimpleValue: " << V << " "
                     << (isInserted ? "Inserted" : "Not inserted") << "\n");
   LiveRange *LR = i->second;
@@ -844,8 +843,9 @@ void GenXLiveness::moveUnifiedRet(Function *OldF, Function *NewF)
   if (i == UnifiedRets.end())
     return;
   Value *UR = i->second;
-  UnifiedRets[NewF] = UR;
+  // Erase first: inserting into the DenseMap may invalidate i.
   UnifiedRets.erase(i);
+  UnifiedRets[NewF] = UR;
   UnifiedRetToFunc[UR] = NewF;
 }
 
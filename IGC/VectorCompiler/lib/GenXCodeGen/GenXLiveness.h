@@ -165,6 +165,7 @@ SPDX-License-Identifier: MIT
 #include "Probe/Assertion.h"
 #include "vc/Utils/General/IndexFlattener.h"
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/IR/DerivedTypes.h"
@@ -456,18 +457,39 @@ public:
 
 } // end namespace genx
 
+// Specialize DenseMapInfo for SimpleValue.
+template <> struct DenseMapInfo<genx::SimpleValue> {
+  static inline genx::SimpleValue getEmptyKey() {
+    return genx::SimpleValue(DenseMapInfo<Value *>::getEmptyKey());
+  }
+  static inline genx::SimpleValue getTombstoneKey() {
+    return genx::SimpleValue(DenseMapInfo<Value *>::getTombstoneKey());
+  }
+  static unsigned getHashValue(const genx::SimpleValue &SV) {
+    return DenseMapInfo<Value *>::getHashValue(SV.getValue()) ^
+           DenseMapInfo<unsigned>::getHashValue(SV.getIndex());
+  }
+  static bool isEqual(const genx::SimpleValue &LHS,
+                      const genx::SimpleValue &RHS) {
+    return LHS == RHS;
+  }
+};
+
 class GenXLiveness : public FGPassImplInterface, public IDMixin<GenXLiveness> {
   FunctionGroup *FG = nullptr;
-  using LiveRangeMap_t = std::map<genx::SimpleValue, genx::LiveRange *>;
+  // Baling, coalescing and register allocation query this map constantly,
+  // so it is hashed rather than ordered. Nothing depends on its iteration
+  // order.
+  using LiveRangeMap_t = DenseMap<genx::SimpleValue, genx::LiveRange *>;
   LiveRangeMap_t LiveRangeMap;
   std::unique_ptr<genx::CallGraph> CG;
   GenXBaling *Baling = nullptr;
   GenXNumbering *Numbering = nullptr;
   const GenXSubtarget *Subtarget = nullptr;
   const DataLayout *DL = nullptr;
-  std::map<Function *, Value *> UnifiedRets;
-  std::map<Value *, Function *> UnifiedRetToFunc;
-  std::map<AssertingVH<Value>, Value *> ArgAddressBaseMap;
+  DenseMap<Function *, Value *> UnifiedRets;
+  DenseMap<Value *, Function *> UnifiedRetToFunc;
+  DenseMap<AssertingVH<Value>, Value *> ArgAddressBaseMap;
   // Flipped ArgAddressBaseMap. Mulpimap is chosen because the same base may be
   // used for different convert.addr instructions.
   std::multimap<Value *, Value *> BaseToArgAddrMap;
@@ -607,24 +629,6 @@ using GenXLivenessWrapper = FunctionGroupWrapperPass<GenXLiveness>;
 
 void initializeGenXLivenessWrapperPass(PassRegistry &);
 
-// Specialize DenseMapInfo for SimpleValue.
-template <> struct DenseMapInfo<genx::SimpleValue> {
-  static inline genx::SimpleValue getEmptyKey() {
-    return genx::SimpleValue(DenseMapInfo<Value *>::getEmptyKey());
-  }
-  static inline genx::SimpleValue getTombstoneKey() {
-    return genx::SimpleValue(DenseMapInfo<Value *>::getTombstoneKey());
-  }
-  static unsigned getHashValue(const genx::SimpleValue &SV) {
-    return DenseMapInfo<Value *>::getHashValue(SV.getValue()) ^
-           DenseMapInfo<unsigned>::getHashValue(SV.getIndex());
-  }
-  static bool isEqual(const genx::SimpleValue &LHS,
-                      const genx::SimpleValue &RHS) {
-    return LHS == RHS;
-  }
-};
-
 } // end namespace llvm
 namespace std {
 template <> struct hash<llvm::genx::Segment> {
@@ -19,7 +19,7 @@ DECLARE_IGC_REGKEY(bool, EnablePreemption,              true,  "Enable generatin
 DECLARE_IGC_REGKEY(bool, ForcePreemptionWA,             false, "Force generating preemptable code across platforms", true)
 DECLARE_IGC_REGKEY(bool, EnableVISANoSchedule,          false, "Enable VISA No-Schedule", true)
 DECLARE_IGC_REGKEY(bool, EnableVISAPreSched,            true,  "Enable VISA Pre-RA Scheduler", true)
-DECLARE_IGC_REGKEY(DWORD, VISAPreSchedCtrl,             0,     "Configure Pre-RA Scheduler, default(0), logging(1), latency(2), pressure(4)", false)
+DECLARE_IGC_REGKEY(DWORD, VISAPreSchedCtrl,             0,     "Configure Pre-RA Scheduler, default(0), logging(1), latency(2), pressure(4)", true)
 DECLARE_IGC_REGKEY(bool, ForceVISAPreSched,             false, "Force enabling of VISA Pre-RA Scheduler", false)
 DECLARE_IGC_REGKEY(DWORD, VISAPreSchedRPThreshold,      0,     "Threshold to commit a pre-RA Scheduling without spills, 0 for the default", false)
 DECLARE_IGC_REGKEY(DWORD, VISAPreSchedExtraGRF,         0,     "Bump up GRF number to make pre-RA Scheduling more greedy, 0 for the default", false)
@@ -59,7 +59,7 @@ DECLARE_IGC_REGKEY(DWORD,DisableHFMath,                 0,     "Disables HF math
 DECLARE_IGC_REGKEY(debugString, VISAOptions,            0,     "Options to vISA. Space-separated options.", true)
 DECLARE_IGC_REGKEY(DWORD,disableIGASyntax,              false, "Disables GEN isa text output using IGA and new syntax.", false)
 DECLARE_IGC_REGKEY(DWORD,disableCompaction,             false, "Disables compaction.", true)
-DECLARE_IGC_REGKEY(DWORD,TotalGRFNum,                   0,     "Total GRF setting for both IGC-LLVM and vISA", false)
+DECLARE_IGC_REGKEY(DWORD,TotalGRFNum,                   0,     "Total GRF setting for both IGC-LLVM and vISA", true)
 DECLARE_IGC_REGKEY(DWORD,TotalGRFNum4CS,                0,     "Total GRF setting for both IGC-LLVM and vISA, for ComputeShader-only experiment.", false)
 DECLARE_IGC_REGKEY(DWORD,ReservedRegisterNum,           0,     "Reserve register number for spill cost testing.", false)
 DECLARE_IGC_REGKEY(bool, ExpandPlane,                   false, "Enable pln to mad macro expansion.", false)
@@ -176,6 +176,7 @@ DECLARE_IGC_REGKEY(DWORD,SetRegisterPressureThresholdForLoopUnroll,       96,
 DECLARE_IGC_REGKEY(DWORD,SetBranchSwapThreshold,        400,   "Set the branch swaping threshold.", false)
 DECLARE_IGC_REGKEY(debugString, LLVMCommandLine,        0,     "applies LLVM command line", false)
 DECLARE_IGC_REGKEY(debugString, SelectiveHashOptions,   0,     "applies options to hash ragne via string", false)
+DECLARE_IGC_REGKEY(debugString, TuningDecisionFile,     0,     "Path to per-shader tuning decisions written by autotune.py. Same syntax as Options.txt, regkeys following a hash: line apply to that shader only", true)
 DECLARE_IGC_REGKEY(bool, DisableDX9LowPrecision,        true,  "Disables HF in DX9.", false)
 DECLARE_IGC_REGKEY(bool, EnablePingPongTextureOpt,      true,  "Enables the Ping Pong texture optimization which is used only for Compute Shaders for back to back dispatches", false)
 DECLARE_IGC_REGKEY(bool, EnableAtomicBranch,            false, "Enable Atomic branch optimization which break atomic into if/else with atomic and read based on the operation", false)
@@ -296,7 +297,7 @@ DECLARE_IGC_REGKEY(DWORD, RouteByLodHint,               0,     "An integer offse
 DECLARE_IGC_REGKEY(bool, EnableTrivialEmulateSinCos,    false, "Enable Emulation for Sine and Cosine instructions", false)
 DECLARE_IGC_REGKEY(DWORD, ld2dmsInstsClubbingThreshold, 3,     "Do not club more than these ld2dms insts into the new BB during MCSOpt", false)
 DECLARE_IGC_REGKEY(DWORD, ForcePerThreadPrivateMemorySize, 0,  "Useful for ensuring a certain amount of private memory when doing a shader override.", true)
-DECLARE_IGC_REGKEY(DWORD, RetryManagerFirstStateId,     0,     "For debugging purposes, it can be useful to start on a particular id rather than id 0.", false)
+DECLARE_IGC_REGKEY(DWORD, RetryManagerFirstStateId,     0,     "For debugging purposes, it can be useful to start on a particular id rather than id 0.", true)
 DECLARE_IGC_REGKEY(bool, DisableSendSrcDstOverlapWA,    false, "Disable Send Source/destination overlap WA which is enabled for GEN10/GEN11 and whenever Wddm2Svm is set in WATable", false)
 DECLARE_IGC_REGKEY(debugString, DisablePassToggles,     0,     "Disable each IGC pass by setting the bit. HEXADECIMAL ONLY!. Ex: C0 is to disable pass 6 and pass 7.", false)
 DECLARE_IGC_REGKEY(bool, ShaderDisplayAllPassesNames,   false, "Display to console all passes name with their ID and occurrence number.", false)
@@ -376,6 +377,7 @@ DECLARE_IGC_REGKEY(bool, EnableWriteOldFPToStack,       true,  "Setting this to
 DECLARE_IGC_REGKEY(bool, ZeBinCompatibleDebugging,      true,  "Setting this to 1 (true) enables embed debug info in zeBinary", true)
 DECLARE_IGC_REGKEY(bool, DebugInfoEnforceAmd64EM,       false, "Enforces elf file with the debug infomation to have eMachine set to AMD64", false)
 DECLARE_IGC_REGKEY(bool, DebugInfoValidation,           false, "Enable optional (strict) checks to detect debug information inconsistencies", false)
+DECLARE_IGC_REGKEY(bool, DebugInfoStringPool,           false, "Emit debug info strings to a pooled .debug_str section (DW_FORM_strp) instead of inlining them, so identical strings are shared across kernels", true)
 DECLARE_IGC_REGKEY(bool, deadLoopForFloatException,           false, "enable a dead loop if float exception happened", false)
 DECLARE_IGC_REGKEY(debugString, ExtraOCLOptions,        0,     "Extra options for OpenCL", true)
 DECLARE_IGC_REGKEY(debugString, ExtraOCLInternalOptions, 0,    "Extra internal options for OpenCL", true)
@@ -398,6 +400,7 @@ DECLARE_IGC_REGKEY(bool, DisableGPGPUIndirectPayload,   false, "Disable OCL indi
 DECLARE_IGC_REGKEY(bool, DisableDSDualPatch,            false, "Setting it to true with enable Single and Dual Patch dispatch mode for Domain Shader", false)
 DECLARE_IGC_REGKEY(bool, DisableMemOpt,                 false, "Disable MemOpt, merging load/store", false)
 DECLARE_IGC_REGKEY(bool, DisableMemOpt2,                false, "Disable MemOpt2", false)
+DECLARE_IGC_REGKEY(bool, EnableCrossBlockMemOpt,        false, "Move loads and stores of control-equivalent blocks next to each other and merge identical loads of if/else arms, so that MemOpt can coalesce them", false)
 DECLARE_IGC_REGKEY(bool, DisablePreRAScheduler,         false, "Disable Pre RA Scheduling", false)
 DECLARE_IGC_REGKEY(DWORD,MaxLiveOutThreshold,           0,     "Max LiveOut Threshold in MemOpt2", false)
 DECLARE_IGC_REGKEY(bool, DisableScalarAtomics,          false, "Disable the Scalar Atomics optimization", false)
@@ -423,6 +426,8 @@ DECLARE_IGC_REGKEY_BITMASK(EarlyOutPatternSelectCS,     0xff,  "Each bit selects
 DECLARE_IGC_REGKEY(bool, OCLEnableReassociate,          false, "Enable reassociation", true)
 DECLARE_IGC_REGKEY(bool, EnableOCLScratchPrivateMemory, true,  "Enable the use of scratch space for private memory [OCL only]", true)
 DECLARE_IGC_REGKEY(bool, EnableMaxWGSizeCalculation,    true,  "Enable max work group size calculation [OCL only]", true)
+DECLARE_IGC_REGKEY(DWORD, SPIRVTranslationCacheSize,    0,     "Number of SPIR-V to LLVM translations kept in memory, keyed by SPIR-V hash and specialization constant values. 0 disables the cache [OCL only]", true)
+DECLARE_IGC_REGKEY(bool, EnableSPIRVLazyFunctionTranslation, true, "Only translate SPIR-V functions reachable from kernels, exported or indirectly referenced functions. Disable to translate the whole module (e.g. for validation) [OCL only]", true)
 DECLARE_IGC_REGKEY(bool, Enable64BitEmulation,          false, "Enable 64-bit emulation", false)
 DECLARE_IGC_REGKEY(bool, Enable64BitEmulationOnSelectedPlatform, true, "Enable 64-bit emulation on selected platforms", false)
 DECLARE_IGC_REGKEY(DWORD, EnableConstIntDivReduction,   0x1,   "Enables strength reduction on integer division/remainder with constant divisors/moduli", true)
@@ -555,6 +560,9 @@ DECLARE_IGC_REGKEY(DWORD, FunctionCloningThreshold,     0,
     "Limits the number of cloned functions when called from multiple function groups." \
     "If number of cloned functions exceeds the threshold, compile the function only once and use address relocation instead." \
     "Setting this to '0' allows IGC to choose the default value.", true)
+DECLARE_IGC_REGKEY(bool, ShareSubroutinesAcrossKernels, false,
+    "If enabled with zebin, subroutines called from more function groups than FunctionCloningThreshold (default 1) are turned into stack calls " \
+    "and compiled once in the indirect call group instead of being cloned into every function group.", true)
 DECLARE_IGC_REGKEY(bool, ForceLowestSIMDForStackCalls,  true, "If enabled, compile to the lowest allowed SIMD mode when stack calls or indirect calls are present", true)
 DECLARE_IGC_REGKEY(DWORD, OCLInlineThreshold,           512,  "Setting OCL inline thershold", true)
 DECLARE_IGC_REGKEY(bool, DisableAddingAlwaysAttribute,  false, "Disable adding always attribute", true)
@@ -690,6 +698,7 @@ DECLARE_IGC_REGKEY(bool, FastCompileRA, false, "Provide the fast compilatoin pat
 DECLARE_IGC_REGKEY(bool, HybridRAWithSpill, false, "Did Hybrid RA with Spill", false)
 DECLARE_IGC_REGKEY(DWORD, AllowStackCallRetry, 2, "Enable/Disable retry when stack function spill. 0 - Don't allow, 1 - Allow retry on kernel group, 2 - Allow retry per function", false)
 DECLARE_IGC_REGKEY(bool, PrintStackCallDebugInfo, false, "Print all debug info to command line related to stack call debugging", true)
+DECLARE_IGC_REGKEY(bool, PrintCrossBlockMemOptStats, false, "Print per kernel how many memory messages CrossBlockMemOpt eliminated, counting the merges MemOpt made of the accesses it moved", false)
 DECLARE_IGC_REGKEY(DWORD, StripDebugInfo, 0,
     "Strip debug info from llvm IR lowered from input to IGC ."\
     "Possible values: 0 - dont strip, 1 - strip all, 2 - strip non-line info",
@@ -705,6 +714,8 @@ DECLARE_IGC_REGKEY(bool, EnableVector8LoadStore, false, "Enable Vectorizer to ge
 DECLARE_IGC_REGKEY(bool, EnableZEBinary, true,  "Force-enable output in ZE binary format. Leave unset for compiler to choose based on current platform's support for ZE binary", true)
 DECLARE_IGC_REGKEY(bool, ExcludeIRFromZEBinary, false, "Exclude IR sections from ZE binary", true)
 DECLARE_IGC_REGKEY(bool, AllocateZeroInitializedVarsInBss, true,  "Allocate zero initialized global variables in .bss section in ZEBinary", true)
+DECLARE_IGC_REGKEY(DWORD, ZEBinaryBuilderThreads, 0, "Number of threads used to prepare per-kernel .ze_info entries in ZEBinary. 0: use hardware concurrency, 1: serial", true)
+DECLARE_IGC_REGKEY(DWORD, CompileMemoryBudgetMB, 0, "Memory budget in MB for vISA arenas and interference matrix per compile. Close to the budget vISA uses sparse interference and linear scan RA, and OpenCL kernels skip SIMD32. 0: no budget", true)
 DECLARE_IGC_REGKEY(DWORD, OverrideOCLMaxParamSize, 0,  "Override the value imposed on the kernel by CL_DEVICE_MAX_PARAMETER_SIZE. Value in bytes, if value==0 no override happens.", true)
 
 DECLARE_IGC_REGKEY(bool, EnableOptReportPrivateMemoryToSLM, false, "[POC] Generate opt report file for moving private memory allocations to SLM.", false)
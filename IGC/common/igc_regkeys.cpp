@@ -40,11 +40,13 @@ SPDX-License-Identifier: MIT
 #include <optional>
 #include "Probe/Assertion.h"
 #include "common/Types.hpp"
+#include "inc/common/lock_stats.h"
 
 // path for IGC registry keys
 #define IGC_REGISTRY_KEY "SOFTWARE\\INTEL\\IGFX\\IGC"
 
 SRegKeysList g_RegKeyList;
+thread_local SRegKeysList* g_pThreadRegKeyList = nullptr;
 
 #if defined(_WIN64) || defined(_WIN32)
 
@@ -759,9 +761,13 @@ static void setIGCKeyOnHash(
     std::vector<HashRange>& hashes, const unsigned value,
     SRegKeyVariableMetaData* var)
 {
-    // hashes can be empty if the var is not set via Options.txt
+    // hashes can be empty if the var is not set via Options.txt. Tuning
+    // decisions carry the parent key's value, so they are not inherited.
     for (size_t i = 0; i < hashes.size(); i++)
-        var->hashes.push_back(hashes[i]);
+    {
+        if (!hashes[i].tuning)
+            var->hashes.push_back(hashes[i]);
+    }
     var->Set();
     var->m_Value = value;
 }
@@ -885,6 +891,25 @@ static void declareIGCKey(
     }
 }
 
+// Adds a tuning decision as hash ranges only. Unlike declareIGCKey it leaves
+// the key's own value and its set state alone, so shaders the decision does
+// not list keep what was set through env, registry or -igc_opts.
+static void declareTuningDecision(
+    const std::string& line, const char* dataType, const char* regkeyName,
+    const std::vector<HashRange>& hashes, SRegKeyVariableMetaData* regKey)
+{
+    bool isSet = false;
+    debugString value = { 0 };
+    setRegkeyFromOption(line, dataType, regkeyName, &value, isSet);
+    if (!isSet)
+        return;
+    for (HashRange range : hashes) {
+        range.tuning = true;
+        memcpy_s(range.m_string, sizeof(value), value, sizeof(value));
+        regKey->hashes.push_back(range);
+    }
+}
+
 static void LoadDebugFlagsFromFile()
 {
     std::ifstream input(GetOptionFile());
@@ -935,6 +960,37 @@ static void LoadDebugFlagsFromString(const char* input)
     setImpliedIGCKeys();
 }
 
+// Loads per-shader tuning decisions written by the offline autotuner
+// (scripts/autotune.py). The file uses Options.txt syntax, e.g.:
+//   hash:abcdabcdabcdabcd
+//   ForceOCLSIMDWidth=16
+//   VISAPreSchedCtrl=4
+// Unlike Options.txt it is read in release builds and silently, and keys
+// not preceded by a hash: line are ignored. A decision only overrides the key
+// for the shaders it lists; every other shader keeps the key's own value.
+static void LoadTuningDecisionsFromFile(const char* path)
+{
+    if (!path || path[0] == '\0') {
+        return;
+    }
+    std::ifstream input(path);
+    std::string line;
+    std::vector<HashRange> hashes;
+
+    while (std::getline(input, line)) {
+        if (line.empty() || line.front() == '#')
+            continue;
+        ParseHashRange(line, hashes);
+#define DECLARE_IGC_REGKEY(dataType, regkeyName, defaultValue, description, releaseMode)         \
+{                                                                                   \
+    declareTuningDecision(line, #dataType, #regkeyName, hashes, &(g_RegKeyList.regkeyName));\
+}
+#include "igc_regkeys.h"
+#undef DECLARE_IGC_REGKEY
+
+    }
+}
+
 void appendToOptionsLogFile(std::string const &message)
 {
     std::string logPath = GetOptionFilePath();
@@ -957,22 +1013,31 @@ void SetCurrentDebugHash(const ShaderHash& hash)
     g_CurrentShaderHash = hash;
 }
 
-bool CheckHashRange(SRegKeyVariableMetaData& varname)
+bool CheckHashRange(const SRegKeyVariableMetaData& varname, const HashRange** matched)
 {
     if (varname.hashes.empty())
         return true;
-    if (!g_CurrentShaderHash.is_set())
+    if (!g_CurrentShaderHash.is_set() && !varname.hashes.front().tuning)
     {
         std::string msg = "Warning: hash not calculated yet; IGC_GET_FLAG_VALUE(" + std::string(varname.GetName()) + ") returned default value";
         appendToOptionsLogFile(msg);
     }
 
+    // A shader that no range matches gets the default, unless all ranges
+    // are tuning decisions: those are an overlay on the key's own value.
+    bool onlyTuning = true;
     for (auto &it : varname.hashes)
     {
+        onlyTuning &= it.tuning;
         unsigned long long CurrHash = it.getHashVal(g_CurrentShaderHash);
         if (CurrHash >= it.start && CurrHash <= it.end)
         {
-            varname.m_Value = it.m_Value;
+            // The value is returned through matched rather than stored in
+            // varname: concurrent compiles of different shaders share it.
+            if (matched)
+                *matched = &it;
+            if (it.tuning)
+                return true;
             constexpr uint32_t Len = 100;
             char msg[Len];
             int size = snprintf(msg, Len, "Shader %#0llx: %s=%d", CurrHash, varname.GetName(), it.m_Value);
@@ -984,7 +1049,77 @@ bool CheckHashRange(SRegKeyVariableMetaData& varname)
             return true;
         }
     }
-    return false;
+    return onlyTuning;
+}
+
+unsigned GetRegKeyValue(const SRegKeyVariableMetaData& varname, bool useValue)
+{
+    const HashRange* matched = nullptr;
+    if (!useValue || !CheckHashRange(varname, &matched))
+        return varname.GetDefault();
+    return matched ? matched->m_Value : varname.m_Value;
+}
+
+const char* GetRegKeyString(const SRegKeyVariableMetaData& varname, bool useValue)
+{
+    const HashRange* matched = nullptr;
+    if (!useValue || !CheckHashRange(varname, &matched))
+        return "";
+    return matched ? matched->m_string : varname.m_string;
+}
+
+// Sets regKey from "name=value," in options, if present.
+static void setRegKeyFromOptions(
+    SRegKeyVariableMetaData& regKey,
+    const std::string& options,
+    bool* RegFlagNameError)
+{
+    std::string nameWithEqual = regKey.GetName();
+    nameWithEqual = nameWithEqual + "=";
+
+    debugString valueFromOptions = { 0 };
+    std::size_t found = options.find(nameWithEqual);
+
+    if (found != std::string::npos)
+    {
+        std::size_t foundComma = options.find(',', found);
+        if (foundComma != std::string::npos)
+        {
+            if (found == 0 || options[found - 1] == ' ' || options[found - 1] == ',')
+            {
+                std::string token = options.substr(found + nameWithEqual.size(), foundComma - (found + nameWithEqual.size()));
+                unsigned int size = sizeof(valueFromOptions);
+                void* pValueFromOptions = &valueFromOptions;
+
+                const char* envValFromOptions = token.c_str();
+                bool valueIsInt = false;
+                if (envValFromOptions != NULL)
+                {
+                    if (size >= sizeof(unsigned int))
+                    {
+                        // Try integer conversion
+                        char* pStopped = nullptr;
+                        unsigned int* puValFromOptions = (unsigned int*)pValueFromOptions;
+                        *puValFromOptions = strtoul(envValFromOptions, &pStopped, 0);
+                        if (pStopped == envValFromOptions + std::strlen(envValFromOptions))
+                        {
+                            valueIsInt = true;
+                        }
+                    }
+                    if (!valueIsInt)
+                    {
+                        // Just return the string
+                        strncpy_s((char*)pValueFromOptions, size, envValFromOptions, size);
+                    }
+                }
+                memcpy_s(regKey.m_string, sizeof(valueFromOptions), valueFromOptions, sizeof(valueFromOptions));
+            }
+            else if(RegFlagNameError != nullptr)
+            {
+                *RegFlagNameError = true;
+            }
+        }
+    }
 }
 
 static void LoadFromRegKeyOrEnvVarOrOptions(
@@ -999,8 +1134,6 @@ static void LoadFromRegKeyOrEnvVarOrOptions(
     {
         debugString value = { 0 };
         const char* name = pRegKeyVariable[i].GetName();
-        std::string nameWithEqual = name;
-        nameWithEqual = nameWithEqual + "=";
 
         bool isSet = ReadIGCRegistry(
             name,
@@ -1015,49 +1148,7 @@ static void LoadFromRegKeyOrEnvVarOrOptions(
             checkAndSetIfKeyHasNoDefaultValue(&pRegKeyVariable[i]);
         }
 
-        debugString valueFromOptions = { 0 };
-        std::size_t found = options.find(nameWithEqual);
-
-        if (found != std::string::npos)
-        {
-            std::size_t foundComma = options.find(',', found);
-            if (foundComma != std::string::npos)
-            {
-                if (found == 0 || options[found - 1] == ' ' || options[found - 1] == ',')
-                {
-                    std::string token = options.substr(found + nameWithEqual.size(), foundComma - (found + nameWithEqual.size()));
-                    unsigned int size = sizeof(value);
-                    void* pValueFromOptions = &valueFromOptions;
-
-                    const char* envValFromOptions = token.c_str();
-                    bool valueIsInt = false;
-                    if (envValFromOptions != NULL)
-                    {
-                        if (size >= sizeof(unsigned int))
-                        {
-                            // Try integer conversion
-                            char* pStopped = nullptr;
-                            unsigned int* puValFromOptions = (unsigned int*)pValueFromOptions;
-                            *puValFromOptions = strtoul(envValFromOptions, &pStopped, 0);
-                            if (pStopped == envValFromOptions + std::strlen(envValFromOptions))
-                            {
-                                valueIsInt = true;
-                            }
-                        }
-                        if (!valueIsInt)
-                        {
-                            // Just return the string
-                            strncpy_s((char*)pValueFromOptions, size, envValFromOptions, size);
-                        }
-                    }
-                    memcpy_s(pRegKeyVariable[i].m_string, sizeof(valueFromOptions), valueFromOptions, sizeof(valueFromOptions));
-                }
-                else if(RegFlagNameError != nullptr)
-                {
-                    *RegFlagNameError = true;
-                }
-            }
-        }
+        setRegKeyFromOptions(pRegKeyVariable[i], options, RegFlagNameError);
     }
     if (IGC_IS_FLAG_ENABLED(PrintDebugSettings))
     {
@@ -1088,9 +1179,9 @@ Output:
 void LoadRegistryKeys(const std::string& options, bool *RegFlagNameError)
 {
     // only load the debug flags once before compiling to avoid any multi-threading issue
-    static std::mutex loadFlags;
+    static LockStats::InstrumentedMutex loadFlags(LockStats::LockId::RegistryKeys);
     static volatile bool flagsSet = false;
-    std::lock_guard<std::mutex> lock(loadFlags);
+    std::lock_guard<LockStats::InstrumentedMutex> lock(loadFlags);
 
     if(!flagsSet)
     {
@@ -1116,6 +1207,7 @@ void LoadRegistryKeys(const std::string& options, bool *RegFlagNameError)
             LoadDebugFlagsFromFile();
             LoadDebugFlagsFromString(IGC_GET_REGKEYSTRING(SelectiveHashOptions));
         }
+        LoadTuningDecisionsFromFile(IGC_GET_REGKEYSTRING(TuningDecisionFile));
         if(IGC_IS_FLAG_ENABLED(LLVMCommandLine))
         {
             std::vector<char*> args;
@@ -1128,6 +1220,28 @@ void LoadRegistryKeys(const std::string& options, bool *RegFlagNameError)
     }
 }
 
+std::shared_ptr<SRegKeysList> CreateRegKeySnapshot(const std::string& options, bool *RegFlagNameError)
+{
+    if (options.empty())
+        return nullptr;
+
+    LoadRegistryKeys();
+    auto snapshot = std::make_shared<SRegKeysList>(g_RegKeyList);
+    SRegKeyVariableMetaData* pRegKeyVariable = (SRegKeyVariableMetaData*)snapshot.get();
+    constexpr unsigned NUM_REGKEY_ENTRIES =
+        sizeof(SRegKeysList) / sizeof(SRegKeyVariableMetaData);
+    for (DWORD i = 0; i < NUM_REGKEY_ENTRIES; i++)
+    {
+        setRegKeyFromOptions(pRegKeyVariable[i], options, RegFlagNameError);
+    }
+
+    // Implied keys go to the snapshot as well. LLVMCommandLine is process
+    // wide and only honored by LoadRegistryKeys().
+    RegKeySnapshotScope scope(snapshot.get());
+    setImpliedIGCKeys();
+    return snapshot;
+}
+
 // Get all keys that have been set explicitly with a non-default value. Return
 // all of them via arguments:
 //     KeyValuePairs:
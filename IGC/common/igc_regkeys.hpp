@@ -17,6 +17,7 @@ PURPOSE: Defines meta data for holding/defining regkey variables
 #include "iStdLib/types.h"
 #include "common/shaderHash.hpp"
 #include "Probe/Assertion.h"
+#include <memory>
 #include <string>
 #include "CommonMacros.h"
 
@@ -44,6 +45,9 @@ struct HashRange
     unsigned long long start;
     unsigned long long end;
     Type Ty;
+    // range from TuningDecisionFile: not logged, and shaders it does not
+    // match keep the key's own value instead of the default
+    bool tuning = false;
     union
     {
         unsigned    m_Value;
@@ -136,41 +140,53 @@ struct SRegKeysList
 #include "igc_regkeys.h"
 };
 #undef DECLARE_IGC_REGKEY
-bool CheckHashRange(SRegKeyVariableMetaData& varname);
+bool CheckHashRange(const SRegKeyVariableMetaData& varname, const HashRange** matched = nullptr);
+// Value of varname for the shader compiled on this thread, or its default if
+// useValue is false or its hash ranges do not match the shader. Regkeys set
+// per hash are resolved without writing to the shared regkey list.
+unsigned GetRegKeyValue(const SRegKeyVariableMetaData& varname, bool useValue);
+const char* GetRegKeyString(const SRegKeyVariableMetaData& varname, bool useValue);
 void setImpliedRegkey(SRegKeyVariableMetaData& name,
     const bool set,
     SRegKeyVariableMetaData& subname,
     const unsigned value);
 
 extern SRegKeysList g_RegKeyList;
+// Regkeys of the compile running on this thread if it was given its own, see
+// CreateRegKeySnapshot(). nullptr if the thread uses g_RegKeyList.
+extern thread_local SRegKeysList* g_pThreadRegKeyList;
+inline SRegKeysList& GetRegKeyList()
+{
+    return g_pThreadRegKeyList ? *g_pThreadRegKeyList : g_RegKeyList;
+}
 #if defined(LINUX_RELEASE_MODE)
 #define IGC_GET_FLAG_VALUE(name)                 \
-  ((CheckHashRange(g_RegKeyList.name) && g_RegKeyList.name.IsReleaseMode()) ? g_RegKeyList.name.m_Value : g_RegKeyList.name.GetDefault())
+  GetRegKeyValue(GetRegKeyList().name, GetRegKeyList().name.IsReleaseMode())
 #define IGC_IS_FLAG_SET(name)                    \
-  (CheckHashRange(g_RegKeyList.name) ? g_RegKeyList.name.IsSet() : false)
-#define IGC_GET_FLAG_DEFAULT_VALUE(name)         (g_RegKeyList.name.GetDefault())
+  (CheckHashRange(GetRegKeyList().name) ? GetRegKeyList().name.IsSet() : false)
+#define IGC_GET_FLAG_DEFAULT_VALUE(name)         (GetRegKeyList().name.GetDefault())
 #define IGC_IS_FLAG_ENABLED(name)                (IGC_GET_FLAG_VALUE(name) != 0)
 #define IGC_IS_FLAG_DISABLED(name)               (!IGC_IS_FLAG_ENABLED(name))
-#define IGC_SET_FLAG_VALUE(name, regkeyValue)    (g_RegKeyList.name.m_Value = regkeyValue)
+#define IGC_SET_FLAG_VALUE(name, regkeyValue)    (GetRegKeyList().name.m_Value = regkeyValue)
 #define IGC_GET_REGKEYSTRING(name)               \
-  ((CheckHashRange(g_RegKeyList.name) && g_RegKeyList.name.IsReleaseMode()) ? g_RegKeyList.name.m_string : "")
+  GetRegKeyString(GetRegKeyList().name, GetRegKeyList().name.IsReleaseMode())
 #define IGC_SET_IMPLIED_REGKEY(name, setOnValue, subname, subvalue) \
-  (setImpliedRegkey(g_RegKeyList.name, (g_RegKeyList.name.m_Value == setOnValue), \
-                    g_RegKeyList.subname, subvalue))
+  (setImpliedRegkey(GetRegKeyList().name, (GetRegKeyList().name.m_Value == setOnValue), \
+                    GetRegKeyList().subname, subvalue))
 #else
 #define IGC_GET_FLAG_VALUE(name)                 \
-  (CheckHashRange(g_RegKeyList.name) ? g_RegKeyList.name.m_Value : g_RegKeyList.name.GetDefault())
+  GetRegKeyValue(GetRegKeyList().name, true)
 #define IGC_IS_FLAG_SET(name)                    \
-  (CheckHashRange(g_RegKeyList.name) ? g_RegKeyList.name.IsSet() : false)
-#define IGC_GET_FLAG_DEFAULT_VALUE(name)         (g_RegKeyList.name.GetDefault())
+  (CheckHashRange(GetRegKeyList().name) ? GetRegKeyList().name.IsSet() : false)
+#define IGC_GET_FLAG_DEFAULT_VALUE(name)         (GetRegKeyList().name.GetDefault())
 #define IGC_IS_FLAG_ENABLED(name)                (IGC_GET_FLAG_VALUE(name) != 0)
 #define IGC_IS_FLAG_DISABLED(name)               (!IGC_IS_FLAG_ENABLED(name))
-#define IGC_SET_FLAG_VALUE(name, regkeyValue)    (g_RegKeyList.name.m_Value = regkeyValue)
+#define IGC_SET_FLAG_VALUE(name, regkeyValue)    (GetRegKeyList().name.m_Value = regkeyValue)
 #define IGC_GET_REGKEYSTRING(name)               \
-  (CheckHashRange(g_RegKeyList.name) ? g_RegKeyList.name.m_string : "")
+  GetRegKeyString(GetRegKeyList().name, true)
 #define IGC_SET_IMPLIED_REGKEY(name, setOnValue, subname, subvalue) \
-  (setImpliedRegkey(g_RegKeyList.name, (g_RegKeyList.name.m_Value == setOnValue), \
-                    g_RegKeyList.subname, subvalue))
+  (setImpliedRegkey(GetRegKeyList().name, (GetRegKeyList().name.m_Value == setOnValue), \
+                    GetRegKeyList().subname, subvalue))
 #endif
 
 #define IGC_REGKEY_OR_FLAG_ENABLED(name, flag) (IGC_IS_FLAG_ENABLED(name) || IGC::Debug::GetDebugFlag(IGC::Debug::DebugFlag::flag))
@@ -197,6 +213,31 @@ void DumpIGCRegistryKeyDefinitions();
 void DumpIGCRegistryKeyDefinitions3(std::string driverRegistryPath, unsigned long pciBus, unsigned long pciDevice, unsigned long pciFunction);
 void LoadRegistryKeys(const std::string& options = "", bool *RegFlagNameError = nullptr);
 void SetCurrentDebugHash(const ShaderHash &hash);
+// Copy of the process wide regkeys with the regkeys in options applied on top,
+// for compiles that are given their own regkeys. Returns nullptr if options is
+// empty, such compiles use g_RegKeyList directly.
+std::shared_ptr<SRegKeysList> CreateRegKeySnapshot(const std::string& options, bool *RegFlagNameError = nullptr);
+
+// Makes the regkey macros read a snapshot on the current thread for the
+// lifetime of the scope, so that compiles with different regkeys can run
+// concurrently in one process. A null snapshot keeps the current regkeys.
+class RegKeySnapshotScope
+{
+public:
+    explicit RegKeySnapshotScope(SRegKeysList* snapshot) : m_pPrevious(g_pThreadRegKeyList)
+    {
+        if (snapshot)
+            g_pThreadRegKeyList = snapshot;
+    }
+    ~RegKeySnapshotScope()
+    {
+        g_pThreadRegKeyList = m_pPrevious;
+    }
+    RegKeySnapshotScope(const RegKeySnapshotScope&) = delete;
+    RegKeySnapshotScope& operator=(const RegKeySnapshotScope&) = delete;
+private:
+    SRegKeysList* m_pPrevious;
+};
 #undef LINUX_RELEASE_MODE
 #else
 static inline void GetKeysSetExplicitly(std::string* KeyValuePairs, std::string* OptionKeys)
@@ -213,6 +254,21 @@ static inline void LoadRegistryKeys(const std::string& options = "", bool *RegFl
     IGC_UNUSED(options);
     IGC_UNUSED(RegFlagNameError);
 }
+struct SRegKeysList {};
+static inline std::shared_ptr<SRegKeysList> CreateRegKeySnapshot(const std::string& options, bool *RegFlagNameError = nullptr)
+{
+    IGC_UNUSED(options);
+    IGC_UNUSED(RegFlagNameError);
+    return nullptr;
+}
+class RegKeySnapshotScope
+{
+public:
+    explicit RegKeySnapshotScope(SRegKeysList* snapshot)
+    {
+        IGC_UNUSED(snapshot);
+    }
+};
 #define IGC_SET_FLAG_VALUE(name, regkeyValue)
 #define DECLARE_IGC_REGKEY(dataType, regkeyName, defaultValue, description, releaseMode) \
     static const unsigned int regkeyName##default = (unsigned int)defaultValue;
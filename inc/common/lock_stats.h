@@ -0,0 +1,109 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2023 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+// Wait time statistics of the locks that serialize concurrent compiles in one
+// process. Shared by IGC and vISA; the counters are read through the exported
+// IGCGetLockStats() of the IGC library, see TranslationBlock.h.
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdint.h>
+
+namespace LockStats
+{
+enum class LockId : unsigned int
+{
+    LLVMGlobals,     // LLVM cl::opt globals and VC compiles
+    RegistryKeys,    // LoadRegistryKeys()
+    VISATextParser,  // vISA text parser
+    SPIRVCache,      // SPIR-V translation cache
+    Count
+};
+
+inline const char* GetLockName(LockId id)
+{
+    switch (id)
+    {
+    case LockId::LLVMGlobals:    return "LLVMGlobals";
+    case LockId::RegistryKeys:   return "RegistryKeys";
+    case LockId::VISATextParser: return "VISATextParser";
+    case LockId::SPIRVCache:     return "SPIRVCache";
+    default:                     return "unknown";
+    }
+}
+
+// Plain copy of the counters of one lock, as returned by IGCGetLockStats().
+struct Entry
+{
+    char name[32];
+    uint64_t acquisitions;
+    uint64_t contended;  // acquisitions that had to wait
+    uint64_t waitNs;     // total time spent waiting
+};
+
+struct Counters
+{
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> waitNs{0};
+};
+
+inline Counters& GetCounters(LockId id)
+{
+    static Counters counters[(unsigned int)LockId::Count];
+    return counters[(unsigned int)id];
+}
+
+// std::mutex that counts how often and how long threads waited for it. The
+// uncontended path costs one try_lock and one atomic increment.
+class InstrumentedMutex
+{
+public:
+    explicit InstrumentedMutex(LockId id) : m_counters(GetCounters(id)) {}
+    InstrumentedMutex(const InstrumentedMutex&) = delete;
+    InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+
+    void lock()
+    {
+        m_counters.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        if (m_mutex.try_lock())
+        {
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        m_mutex.lock();
+        auto waited = std::chrono::steady_clock::now() - start;
+        m_counters.contended.fetch_add(1, std::memory_order_relaxed);
+        m_counters.waitNs.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count(),
+            std::memory_order_relaxed);
+    }
+
+    bool try_lock()
+    {
+        if (!m_mutex.try_lock())
+        {
+            return false;
+        }
+        m_counters.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void unlock()
+    {
+        m_mutex.unlock();
+    }
+
+private:
+    std::mutex m_mutex;
+    Counters& m_counters;
+};
+} // namespace LockStats
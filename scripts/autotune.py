@@ -0,0 +1,288 @@
+# ========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2023 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+# =========================== end_copyright_notice =============================
+
+# Offline per-shader autotuner for IGC.
+#
+# Compiles every input under each point of a search space of IGC regkeys,
+# ranks the variants per shader hash and writes a tuning decision file. When
+# IGC_TuningDecisionFile points to that file, normal compiles of a shader
+# with a matching hash pick up the stored regkeys automatically.
+#
+# The compiler is any command line that ends up calling IGC, e.g. ocloc:
+#
+#   autotune.py --database tuning.txt \
+#       --compiler "ocloc compile -q -file {input} -device dg2 -out_dir {workdir}" \
+#       kernels/*.cl
+#
+# Results are collected through shader dumps (IGC_ShaderDumpEnable,
+# IGC_DumpToCustomDir) and the -dumpVISAJsonStats option of vISA. Dumps are
+# only written by IGC builds with debug regkeys, i.e. Linux builds and
+# Debug/ReleaseInternal builds on Windows, so tuning has to run on such a
+# build. Release drivers only read the resulting decision file.
+#
+# Regkeys of a variant are passed as IGC_<key>=<value> environment variables,
+# together with the shader dump and vISA JSON stats options used to collect
+# results. Variants are ranked either by the static cycle estimate of vISA,
+# normalized to one SIMD lane, or by a score file of measured run times:
+#
+#   {"<asm hash>": {"<variant>": <time>, ...}, ...}
+#
+# where <variant> is as printed by this script, e.g.
+# "ForceOCLSIMDWidth=16,VISAPreSchedCtrl=4". Lower is better in both cases.
+#
+# The decision file uses Options.txt syntax:
+#
+#   hash:0123456789abcdef
+#   ForceOCLSIMDWidth=16
+#   VISAPreSchedCtrl=4
+
+import argparse
+import concurrent.futures
+import glob
+import itertools
+import json
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# Regkeys that are tuned and the values tried, first value is the default.
+DEFAULT_SEARCH_SPACE = {
+    'ForceOCLSIMDWidth': [0, 8, 16, 32],
+    'VISAPreSchedCtrl': [0, 2, 4],
+    # 1 starts at the retry state: no LICM, more sinking, remat, large GRF
+    'RetryManagerFirstStateId': [0, 1],
+    'TotalGRFNum': [0, 256],
+}
+
+DUMP_NAME_RE = re.compile(r'asm(?P<hash>[0-9a-f]{16})'
+                          r'.*?(?:_(?P<retry>\d+))?_simd(?P<simd>\d+)')
+
+
+def VariantName(variant):
+    return ','.join('{0}={1}'.format(k, v) for k, v in variant)
+
+
+def Variants(searchSpace):
+    keys = sorted(searchSpace)
+    for values in itertools.product(*(searchSpace[k] for k in keys)):
+        yield tuple(zip(keys, values))
+
+
+def IsDefault(variant, searchSpace):
+    return all(searchSpace[k][0] == v for k, v in variant)
+
+
+def ReadStats(dumpDir):
+    # Returns {asm hash: {kernel: (retry id, simd, stats)}}, keeping the last
+    # retry of each kernel as that is the code that is actually used. Without
+    # a forced SIMD width several widths may be dumped, keep the cheapest.
+    results = {}
+    for path in glob.glob(os.path.join(dumpDir, '**', '*.stats.json'),
+                          recursive=True):
+        match = DUMP_NAME_RE.search(os.path.basename(path))
+        if not match:
+            continue
+        shaderHash = match.group('hash')
+        retry = int(match.group('retry') or 0)
+        simd = int(match.group('simd'))
+        with open(path) as f:
+            data = json.load(f)
+        kernels = results.setdefault(shaderHash, {})
+        for kernel, stats in data.items():
+            if isinstance(stats, list):
+                stats = stats[0]
+            entry = (retry, simd, stats)
+            old = kernels.get(kernel)
+            if (old is None or old[0] < retry or
+                    (old[0] == retry and
+                     StaticCost({kernel: entry}) < StaticCost({kernel: old}))):
+                kernels[kernel] = entry
+    return results
+
+
+def StaticCost(kernels):
+    # Estimated cycles per work item, summed over kernels of the shader.
+    # Spills are already part of the cycle estimate, fills/spills break ties.
+    cycles = 0.0
+    spills = 0
+    for _, simd, stats in kernels.values():
+        cycles += stats.get('numCycles', 0) / float(max(simd, 1))
+        spills += stats.get('numGRFSpillFill', 0)
+    return (cycles, spills)
+
+
+def Compile(compiler, inputFile, variant, extraEnv):
+    workDir = tempfile.mkdtemp(prefix='igc_autotune_')
+    dumpDir = os.path.join(workDir, 'dump') + os.sep
+    os.mkdir(dumpDir)
+    env = dict(os.environ)
+    env.update(extraEnv)
+    env.update({
+        'IGC_ShaderDumpEnable': '1',
+        'IGC_ShaderDumpPidDisable': '1',
+        'IGC_DumpToCustomDir': dumpDir,
+        'IGC_VISAOptions': (env.get('IGC_VISAOptions', '') +
+                            ' -dumpVISAJsonStats').strip(),
+    })
+    for key, value in variant:
+        env['IGC_' + key] = str(value)
+    cmd = shlex.split(compiler.format(input=os.path.abspath(inputFile),
+                                      workdir=workDir))
+    try:
+        with open(os.path.join(workDir, 'compile.log'), 'w') as log:
+            rc = subprocess.call(cmd, cwd=workDir, env=env, stdout=log,
+                                 stderr=subprocess.STDOUT)
+        return rc, ReadStats(dumpDir) if rc == 0 else {}
+    finally:
+        shutil.rmtree(workDir, ignore_errors=True)
+
+
+def Rank(results, searchSpace, scores):
+    # results: {variant: {asm hash: kernels}}
+    # Returns {asm hash: best variant}, shaders for which the default wins
+    # are left out.
+    costs = {}
+    for variant, hashes in results.items():
+        name = VariantName(variant)
+        for shaderHash, kernels in hashes.items():
+            if scores is not None:
+                score = scores.get(shaderHash, {}).get(name)
+                if score is None:
+                    continue
+                cost = (float(score), 0)
+            else:
+                cost = StaticCost(kernels)
+            costs.setdefault(shaderHash, []).append((cost, variant))
+
+    decisions = {}
+    for shaderHash, candidates in costs.items():
+        # Prefer the default on ties so that only real wins are stored.
+        candidates.sort(key=lambda c: (c[0],
+                                       not IsDefault(c[1], searchSpace)))
+        best = candidates[0][1]
+        if not IsDefault(best, searchSpace):
+            decisions[shaderHash] = best
+    return decisions
+
+
+def ReadDatabase(path):
+    decisions = {}
+    if not path or not os.path.exists(path):
+        return decisions
+    shaderHash = None
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith('#'):
+                continue
+            if line.startswith('hash:'):
+                shaderHash = line[len('hash:'):].lower()
+                if shaderHash.startswith('0x'):
+                    shaderHash = shaderHash[2:]
+                decisions[shaderHash] = []
+            elif shaderHash is not None and '=' in line:
+                key, _, value = line.partition('=')
+                decisions[shaderHash].append((key, value))
+    return {h: tuple(v) for h, v in decisions.items()}
+
+
+def WriteDatabase(path, decisions):
+    with open(path, 'w') as f:
+        f.write('# Generated by autotune.py, use with IGC_TuningDecisionFile\n')
+        for shaderHash in sorted(decisions):
+            f.write('hash:{0}\n'.format(shaderHash))
+            for key, value in decisions[shaderHash]:
+                f.write('{0}={1}\n'.format(key, value))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Tune IGC regkeys per shader and write a decision file '
+                    'for IGC_TuningDecisionFile.')
+    parser.add_argument('inputs', nargs='+',
+                        help='inputs passed to the compiler as {input}')
+    parser.add_argument('--compiler', required=True,
+                        help='compiler command line, {input} and {workdir} '
+                             'are replaced by input file and a scratch '
+                             'directory')
+    parser.add_argument('--database', required=True,
+                        help='decision file to write, existing decisions for '
+                             'other shaders are kept')
+    parser.add_argument('--search-space',
+                        help='JSON file with {regkey: [values]}, first value '
+                             'is the default, default: ' +
+                        json.dumps(DEFAULT_SEARCH_SPACE))
+    parser.add_argument('--score-file',
+                        help='JSON file with measured times per hash and '
+                             'variant, used instead of the static cost model')
+    parser.add_argument('--env', action='append', default=[],
+                        metavar='IGC_KEY=VALUE',
+                        help='extra environment for every compile')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count() or 1,
+                        help='compiles to run in parallel')
+    args = parser.parse_args()
+
+    searchSpace = DEFAULT_SEARCH_SPACE
+    if args.search_space:
+        with open(args.search_space) as f:
+            searchSpace = json.load(f)
+    scores = None
+    if args.score_file:
+        with open(args.score_file) as f:
+            scores = {h.lower(): v for h, v in json.load(f).items()}
+    extraEnv = dict(e.partition('=')[::2] for e in args.env)
+
+    variants = list(Variants(searchSpace))
+    results = {v: {} for v in variants}
+    failed = 0
+    with concurrent.futures.ThreadPoolExecutor(max(1, args.jobs)) as pool:
+        futures = {}
+        for inputFile in args.inputs:
+            for variant in variants:
+                future = pool.submit(Compile, args.compiler, inputFile,
+                                     variant, extraEnv)
+                futures[future] = (inputFile, variant)
+        for future in concurrent.futures.as_completed(futures):
+            inputFile, variant = futures[future]
+            rc, hashes = future.result()
+            if rc != 0:
+                # Not every variant is legal for every shader, e.g. SIMD8
+                # on platforms without it.
+                failed += 1
+                sys.stderr.write('{0} [{1}]: failed ({2})\n'.format(
+                    inputFile, VariantName(variant), rc))
+                continue
+            results[variant].update(hashes)
+
+    if not any(results.values()):
+        sys.stderr.write('no vISA stats were dumped; tuning needs an IGC '
+                         'build that writes shader dumps\n')
+        return 1
+
+    decisions = ReadDatabase(args.database)
+    tuned = Rank(results, searchSpace, scores)
+    # Shaders that were re-tuned and now prefer the default lose their entry.
+    for shaderHash in set(h for r in results.values() for h in r):
+        decisions.pop(shaderHash, None)
+    for shaderHash, variant in tuned.items():
+        decisions[shaderHash] = tuple(
+            (k, v) for k, v in variant if searchSpace[k][0] != v)
+        sys.stdout.write('{0}: {1}\n'.format(shaderHash,
+                                             VariantName(variant)))
+    WriteDatabase(args.database, decisions)
+    sys.stdout.write('{0} shader(s) tuned, {1} compile(s) failed\n'.format(
+        len(tuned), failed))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -19,6 +19,8 @@ int currentMallocSize = 0;
 #endif
 using namespace vISA;
 
+thread_local MemTracker *MemTracker::active = nullptr;
+
 void *ArenaHeader::AllocSpace(size_t size, size_t al) {
   vASSERT(DefaultAlign(size_t(_nextByte)) == size_t(_nextByte));
 
@@ -51,4 +53,10 @@ void ArenaManager::FreeArenas() {
   }
 
   _arenas = 0;
+
+  if (_tracker) {
+    _tracker->release(_trackedSize);
+    _tracker = nullptr;
+    _trackedSize = 0;
+  }
 }
@@ -93,6 +93,54 @@ private:
   size_t size;
 };
 
+// Per-compile accounting of memory held by vISA arenas and other large
+// allocations (e.g. the dense interference matrix), with an optional budget.
+// A tracker is made active for the current thread with MemTracker::Scope;
+// arenas created while it is active are charged to it until they are freed.
+// The tracker must outlive every arena charged to it.
+class MemTracker {
+public:
+  void setBudget(size_t bytes) { budget = bytes; }
+  size_t getBudget() const { return budget; }
+  size_t getCurrent() const { return current; }
+  size_t getPeak() const { return peak; }
+
+  void allocate(size_t size) {
+    current += size;
+    if (current > peak)
+      peak = current;
+  }
+
+  void release(size_t size) {
+    vASSERT(size <= current);
+    current -= size;
+  }
+
+  // Return true if holding size more bytes would take the usage above
+  // percent% of the budget. Always false if there is no budget.
+  bool wouldExceed(size_t size, unsigned percent = 100) const {
+    return budget != 0 && (current + size) * 100 > budget * percent;
+  }
+
+  static MemTracker *getActive() { return active; }
+
+  class Scope {
+  public:
+    Scope(MemTracker &tracker) : prev(active) { active = &tracker; }
+    ~Scope() { active = prev; }
+
+  private:
+    MemTracker *prev;
+  };
+
+private:
+  size_t budget = 0;
+  size_t current = 0;
+  size_t peak = 0;
+
+  static thread_local MemTracker *active;
+};
+
 class ArenaManager {
   friend class Mem_Manager;
 
@@ -148,6 +196,15 @@ private:
 
     _arenas = newArena;
 
+    // Charge the arena to the tracker active when this manager created its
+    // first charged arena, so the same tracker is released in FreeArenas.
+    MemTracker *tracker = MemTracker::getActive();
+    if (tracker && (!_tracker || _tracker == tracker)) {
+      _tracker = tracker;
+      _tracker->allocate(arenaDataSize);
+      _trackedSize += arenaDataSize;
+    }
+
 #ifdef COLLECT_ALLOCATION_STATS
     numMallocCalls++;
     totalMallocSize += arenaDataSize;
@@ -174,6 +231,8 @@ private:
 
   ArenaHeader *_arenas;
   const size_t _defaultArenaSize;
+  MemTracker *_tracker = nullptr;
+  size_t _trackedSize = 0;
 };
 } // namespace vISA
 #endif
@@ -640,6 +640,9 @@ public:
 private:
   const vISA::PlatformInfo *m_platformInfo;
 
+  // Declared before m_mem and the kernels allocated from it, since arenas
+  // created during Compile() are charged to it until they are freed.
+  vISA::MemTracker m_memTracker;
   vISA::Mem_Manager m_mem;
   const VISA_BUILDER_OPTION mBuildOption;
   // FIXME: we need to make 3D/media per kernel instead of per builder
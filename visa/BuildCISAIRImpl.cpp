@@ -26,6 +26,7 @@ SPDX-License-Identifier: MIT
 #include "G4_IR.hpp"
 #include "IsaVerification.h"
 #include "IGC/common/StringMacros.hpp"
+#include "inc/common/lock_stats.h"
 
 #include <fstream>
 #include <functional>
@@ -1391,11 +1392,11 @@ typedef struct yy_buffer_state *YY_BUFFER_STATE;
 extern int CISAparse(CISA_IR_Builder *builder);
 extern YY_BUFFER_STATE CISA_scan_string(const char *yy_str);
 extern void CISA_delete_buffer(YY_BUFFER_STATE buf);
-static std::mutex mtx;
+static LockStats::InstrumentedMutex mtx(LockStats::LockId::VISATextParser);
 
 int CISA_IR_Builder::ParseVISAText(const std::string &visaText,
                                    const std::string &visaTextFile) {
-  const std::lock_guard<std::mutex> lock(mtx);
+  const std::lock_guard<LockStats::InstrumentedMutex> lock(mtx);
   // Direct output of parser to null
 #if defined(_WIN32)
   CISAout = fopen("nul", "w");
@@ -1608,6 +1609,11 @@ int CISA_IR_Builder::Compile(const char *nameInput, std::ostream *os,
 
   VISAKernelImpl *oldMainKernel = nullptr;
   if (IS_GEN_BOTH_PATH) {
+    // Charge arenas created by the compilation below to this builder.
+    m_memTracker.setBudget((size_t)m_options.getuInt32Option(vISA_MemBudgetMB)
+                           << 20);
+    vISA::MemTracker::Scope memTrackerScope(m_memTracker);
+
     bool isInPatchingMode =
         m_options.getuInt32Option(vISA_CodePatch) >= CodePatch_Enable_NoLTO &&
         m_prevKernel;
@@ -1673,6 +1679,8 @@ int CISA_IR_Builder::Compile(const char *nameInput, std::ostream *os,
         continue;
       }
       int status = kernel->compileFastPath();
+      kernel->getIRBuilder()->getJitInfo()->stats.peakMemoryKB =
+          (uint32_t)(m_memTracker.getPeak() >> 10);
       if (status != VISA_SUCCESS) {
         stopTimer(TimerID::TOTAL);
         if (status == VISA_EARLY_EXIT)
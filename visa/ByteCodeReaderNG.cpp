@@ -46,6 +46,7 @@ SPDX-License-Identifier: MIT
 #include "VISAKernel.h"
 
 #include <list>
+#include <unordered_map>
 
 // bfi can have 7 operands
 #define COMMON_ISA_MAX_NUM_OPND_ARITH_LOGIC 7
@@ -79,6 +80,9 @@ struct RoutineContainer {
   unsigned inputVarsCount;
 
   std::vector<std::string> stringPool;
+  // If set, collects the names of the functions the routine calls or takes
+  // the address of.
+  std::vector<std::string> *referencedFuncs = nullptr;
 
   CISA_IR_Builder *builder = nullptr;
   VISAKernel *kernelBuilder = nullptr;
@@ -1161,6 +1165,8 @@ static void readInstructionControlFlow(unsigned &bytePos, const char *buf,
     if (opcode == ISA_FCALL) {
       uint8_t argSize = readPrimitiveOperandNG<uint8_t>(bytePos, buf);
       uint8_t retSize = readPrimitiveOperandNG<uint8_t>(bytePos, buf);
+      if (container.referencedFuncs)
+        container.referencedFuncs->push_back(container.stringPool[labelId]);
       kernelBuilder->AppendVISACFFunctionCallInst(
           pred, emask, esize, container.stringPool[labelId], argSize, retSize);
       return;
@@ -1207,6 +1213,9 @@ static void readInstructionControlFlow(unsigned &bytePos, const char *buf,
   case ISA_FADDR: {
     uint16_t sym_name_idx = readPrimitiveOperandNG<uint16_t>(bytePos, buf);
     VISA_VectorOpnd *dst = readVectorOperandNG(bytePos, buf, container, true);
+    if (container.referencedFuncs)
+      container.referencedFuncs->push_back(
+          container.stringPool[sym_name_idx]);
     kernelBuilder->AppendVISACFSymbolInst(container.stringPool[sym_name_idx],
                                           dst);
     return;
@@ -3027,6 +3036,57 @@ static int processCommonISAHeader(common_isa_header &cisaHdr,
   return 0;
 }
 
+// Builds the functions of the vISA binary and appends them to kernels. If
+// referencedFuncs is given, it holds the functions referenced by the kernels
+// read so far, and only those functions and the ones they reference in turn
+// are decoded, in the order they are first referenced. The function table in
+// the header gives the offset of every body, so unreferenced functions are
+// skipped without being read at all.
+static void readFunctionsNG(const char *buf, common_isa_header &isaHeader,
+                            CISA_IR_Builder *builder, vISA::Mem_Manager &mem,
+                            std::vector<VISAKernel *> &kernels,
+                            std::vector<std::string> *referencedFuncs) {
+  auto readFunction = [&](unsigned i) {
+    RoutineContainer container;
+    container.builder = builder;
+    container.majorVersion = isaHeader.major_version;
+    container.minorVersion = isaHeader.minor_version;
+    container.referencedFuncs = referencedFuncs;
+
+    unsigned bytePos = isaHeader.functions[i].offset;
+
+    VISAFunction *funcPtr = NULL;
+    builder->AddFunction(funcPtr, isaHeader.functions[i].name);
+
+    container.kernelBuilder = (VISAKernel *)funcPtr;
+    kernels.push_back(container.kernelBuilder);
+
+    readRoutineNG(bytePos, buf, mem, container);
+  };
+
+  if (!referencedFuncs) {
+    for (unsigned int i = 0; i < isaHeader.num_functions; i++) {
+      readFunction(i);
+    }
+    return;
+  }
+
+  std::unordered_map<std::string, unsigned> funcIndex;
+  for (unsigned int i = 0; i < isaHeader.num_functions; i++) {
+    funcIndex.emplace(isaHeader.functions[i].name, i);
+  }
+  std::vector<bool> isRead(isaHeader.num_functions, false);
+  // referencedFuncs grows as the functions are read.
+  for (size_t next = 0; next < referencedFuncs->size(); next++) {
+    auto it = funcIndex.find((*referencedFuncs)[next]);
+    if (it == funcIndex.end() || isRead[it->second]) {
+      continue;
+    }
+    isRead[it->second] = true;
+    readFunction(it->second);
+  }
+}
+
 //
 // buf -- vISA binary to be processed.  For offline compile it's always the
 // entire vISA object.
@@ -3036,6 +3096,8 @@ static int processCommonISAHeader(common_isa_header &cisaHdr,
 // kernels -- IR for the vISA kernel
 //      if kernelName is specified, return that kernel only in kernels[0]
 //      otherwise, all kernels in the isa are processed and returned in kernel
+//      functions follow the kernels; with -skipUnreferencedFuncs only the
+//      ones called or address-taken (transitively) from them are built
 // kernelName -- name of the kernel to be processed.  If null, all kernels will
 // be built majorVerion/minorVersion -- version of the vISA binary returns true
 // if IR build succeeds, false otherwise
@@ -3057,6 +3119,12 @@ bool readIsaBinaryNG(const char *buf, CISA_IR_Builder *builder,
   // unaligned oword read) would not work correctly
   builder->CISA_IR_setVersion(isaHeader.major_version, isaHeader.minor_version);
 
+  std::vector<std::string> referencedFuncNames;
+  std::vector<std::string> *referencedFuncs =
+      builder->getOptions()->getOption(vISA_SkipUnreferencedFuncs)
+          ? &referencedFuncNames
+          : nullptr;
+
   if (kernelName) {
     int kernelIndex = -1;
     for (unsigned i = 0; i < isaHeader.num_kernels; i++) {
@@ -3077,24 +3145,13 @@ bool readIsaBinaryNG(const char *buf, CISA_IR_Builder *builder,
     container.kernelBuilder = NULL;
     container.majorVersion = isaHeader.major_version;
     container.minorVersion = isaHeader.minor_version;
+    container.referencedFuncs = referencedFuncs;
 
     builder->AddKernel(container.kernelBuilder,
                        isaHeader.kernels[kernelIndex].name);
     kernels.push_back(container.kernelBuilder);
 
     readRoutineNG(bytePos, buf, binaryReaderMem, container);
-
-    for (unsigned int i = 0; i < isaHeader.num_functions; i++) {
-      bytePos = isaHeader.functions[i].offset;
-
-      VISAFunction *funcPtr = NULL;
-      builder->AddFunction(funcPtr, isaHeader.functions[i].name);
-
-      container.kernelBuilder = (VISAKernel *)funcPtr;
-      kernels.push_back(container.kernelBuilder);
-
-      readRoutineNG(bytePos, buf, binaryReaderMem, container);
-    }
   } else {
     for (unsigned int k = 0; k < isaHeader.num_kernels; k++) {
       bytePos = isaHeader.kernels[k].offset;
@@ -3104,31 +3161,17 @@ bool readIsaBinaryNG(const char *buf, CISA_IR_Builder *builder,
       container.kernelBuilder = NULL;
       container.majorVersion = isaHeader.major_version;
       container.minorVersion = isaHeader.minor_version;
+      container.referencedFuncs = referencedFuncs;
 
       builder->AddKernel(container.kernelBuilder, isaHeader.kernels[k].name);
       kernels.push_back(container.kernelBuilder);
 
       readRoutineNG(bytePos, buf, binaryReaderMem, container);
     }
-
-    for (unsigned int i = 0; i < isaHeader.num_functions; i++) {
-      RoutineContainer container;
-
-      container.builder = builder;
-      container.majorVersion = isaHeader.major_version;
-      container.minorVersion = isaHeader.minor_version;
-
-      bytePos = isaHeader.functions[i].offset;
-
-      VISAFunction *funcPtr = NULL;
-      builder->AddFunction(funcPtr, isaHeader.functions[i].name);
-
-      container.kernelBuilder = (VISAKernel *)funcPtr;
-      kernels.push_back(container.kernelBuilder);
-
-      readRoutineNG(bytePos, buf, binaryReaderMem, container);
-    }
   }
 
+  readFunctionsNG(buf, isaHeader, builder, binaryReaderMem, kernels,
+                  referencedFuncs);
+
   return true;
 }
@@ -94,6 +94,10 @@ class G4_BB {
 
   bool Latency_Sched;
 
+  // execution frequency relative to the kernel entry as given by the
+  // -blockProfile file, negative if there is no profile data for this block
+  float profileFreq = -1.0f;
+
   // the physical pred/succ for this block (i.e., the pred/succ for this
   // block in the BB list).  Note that some transformations may rearrange
   // BB layout, so for safety it's best to recompute this
@@ -258,6 +262,11 @@ public:
   bool isDivergent() const { return divergent; }
   void setLatencySched(bool val) { Latency_Sched = val; }
   bool isLatencySched() const { return Latency_Sched; }
+  void setProfileFreq(float val) { profileFreq = val; }
+  float getProfileFreq() const { return profileFreq; }
+  bool hasProfileFreq() const { return profileFreq >= 0.0f; }
+  // block that the profile says is never executed
+  bool isProfiledCold() const { return profileFreq == 0.0f; }
   bool isAllLaneActive() const;
 
   unsigned getScopeID() const { return scopeID; }
@@ -69,7 +69,9 @@ typedef std::list<vISA::G4_INST *, INST_LIST_NODE_ALLOCATOR>::reverse_iterator
     INST_LIST_RITER;
 
 typedef std::pair<vISA::G4_INST *, Gen4_Operand_Number> USE_DEF_NODE;
-typedef vISA::std_arena_based_allocator<USE_DEF_NODE> USE_DEF_ALLOCATOR;
+// Def-use edges are added and removed all the time (e.g. every
+// localDataFlowAnalysis rebuilds them), so recycle their list nodes.
+typedef vISA::std_pool_allocator<USE_DEF_NODE> USE_DEF_ALLOCATOR;
 
 typedef std::list<USE_DEF_NODE, USE_DEF_ALLOCATOR> USE_EDGE_LIST;
 typedef std::list<USE_DEF_NODE, USE_DEF_ALLOCATOR>::iterator USE_EDGE_LIST_ITER;
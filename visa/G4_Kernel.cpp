@@ -11,6 +11,7 @@ SPDX-License-Identifier: MIT
 #include "DebugInfo.h"
 #include "G4_BB.hpp"
 #include "VarSplit.h"
+#include "Passes/BlockProfile.hpp"
 #include "BinaryEncodingIGA.h"
 #include "Common_ISA_framework.h"
 #include "VISAKernel.h"
@@ -529,6 +530,11 @@ G4_Kernel::~G4_Kernel() {
     varSplitPass = nullptr;
   }
 
+  if (blockProfile) {
+    delete blockProfile;
+    blockProfile = nullptr;
+  }
+
   Declares.clear();
 }
 
@@ -868,6 +874,15 @@ VarSplitPass *G4_Kernel::getVarSplitPass() {
   return varSplitPass;
 }
 
+BlockProfile *G4_Kernel::getBlockProfile() {
+  if (blockProfile)
+    return blockProfile;
+
+  blockProfile = new BlockProfile(*this);
+
+  return blockProfile;
+}
+
 unsigned G4_Kernel::getLargestInputRegister() {
   const unsigned inputCount = fg.builder->getInputCount();
   unsigned regNum = 0;
@@ -132,6 +132,7 @@ private:
 class G4_BB;
 class KernelDebugInfo;
 class VarSplitPass;
+class BlockProfile;
 
 
 // Handles information for GRF selection
@@ -302,6 +303,7 @@ private:
   bool m_hasIndirectCall = false;
 
   VarSplitPass *varSplitPass = nullptr;
+  BlockProfile *blockProfile = nullptr;
   GRFMode grfMode;
 
   // map key is filename string with complete path.
@@ -574,6 +576,7 @@ public:
   std::string getDebugSrcLine(const std::string &filename, int lineNo);
 
   VarSplitPass *getVarSplitPass();
+  BlockProfile *getBlockProfile();
 
   VISATarget getKernelType() const { return kernelType; }
   void setKernelType(VISATarget t) { kernelType = t; }
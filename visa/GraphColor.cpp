@@ -13,6 +13,7 @@ SPDX-License-Identifier: MIT
 #include "LinearScanRA.h"
 #include "LocalRA.h"
 #include "Optimizer.h"
+#include "Passes/BlockProfile.hpp"
 #include "PointsToAnalysis.h"
 #include "RPE.h"
 #include "Rematerialization.h"
@@ -61,6 +62,12 @@ Interference::Interference(const LivenessAnalysis *l,
       maxId(n), splitStartId(ns), splitNum(nm), liveAnalysis(l),
       rowSize(maxId / BITS_DWORD + 1), aug(g.kernel, *this, *l, lr, g) {
   denseMatrixLimit = builder.getuint32Option(vISA_DenseMatrixLimit);
+  memTracker = MemTracker::getActive();
+  // The dense matrix is quadratic in the number of variables; use the sparse
+  // one instead if the dense one would not fit into the memory budget.
+  if (memTracker && memTracker->wouldExceed(getDenseMatrixBytes())) {
+    denseMatrixLimit = 0;
+  }
 }
 
 criticalCmpForEndInterval::criticalCmpForEndInterval(GlobalRA &g) : gra(g) {}
@@ -2034,13 +2041,27 @@ uint32_t GlobalRA::getRefCount(int loopNestLevel) {
                             std::min(loopNestLevel, 8));
 }
 
+// Weight of one reference in bb. Uses the profiled block frequency if there
+// is one, else the static estimate from loop nesting.
+uint32_t GlobalRA::getRefCount(const G4_Kernel &kernel, const G4_BB *bb) {
+  if (bb->hasProfileFreq()) {
+    // Keep profiled weights in the range of the static ones, and never 0 as
+    // even a reference that is never executed must keep its live range
+    // non-free to spill.
+    float maxRefCount = (float)getRefCount(8);
+    return (uint32_t)std::max(1.0f,
+                              std::min(bb->getProfileFreq(), maxRefCount));
+  }
+  return getRefCount(
+      kernel.getOption(vISA_ConsiderLoopInfoInRA) ? bb->getNestLevel() : 0);
+}
+
 // handle return value interference for fcall
 void Interference::buildInterferenceForFcall(
     G4_BB *bb, SparseBitSet &live, G4_INST *inst,
     std::list<G4_INST *>::reverse_iterator i, const G4_VarBase *regVar) {
   vISA_ASSERT(inst->opcode() == G4_pseudo_fcall, "expect fcall inst");
-  unsigned refCount = GlobalRA::getRefCount(
-      kernel.getOption(vISA_ConsiderLoopInfoInRA) ? bb->getNestLevel() : 0);
+  unsigned refCount = GlobalRA::getRefCount(kernel, bb);
 
   if (regVar->isRegAllocPartaker()) {
     unsigned id = static_cast<const G4_RegVar *>(regVar)->getId();
@@ -2061,8 +2082,7 @@ bool GlobalRA::isReRAPass() {
 void Interference::buildInterferenceForDst(
     G4_BB *bb, SparseBitSet &live, G4_INST *inst,
     std::list<G4_INST *>::reverse_iterator i, G4_DstRegRegion *dst) {
-  unsigned refCount = GlobalRA::getRefCount(
-      kernel.getOption(vISA_ConsiderLoopInfoInRA) ? bb->getNestLevel() : 0);
+  unsigned refCount = GlobalRA::getRefCount(kernel, bb);
 
   if (dst->getBase()->isRegAllocPartaker()) {
     unsigned id = ((G4_RegVar *)dst->getBase())->getId();
@@ -2128,8 +2148,7 @@ void Interference::buildInterferenceForDst(
 
 void Interference::buildInterferenceWithinBB(G4_BB *bb, SparseBitSet &live) {
   DebugInfoState state;
-  unsigned refCount = GlobalRA::getRefCount(
-      kernel.getOption(vISA_ConsiderLoopInfoInRA) ? bb->getNestLevel() : 0);
+  unsigned refCount = GlobalRA::getRefCount(kernel, bb);
 
   for (auto i = bb->rbegin(); i != bb->rend(); i++) {
     G4_INST *inst = (*i);
@@ -9496,6 +9515,9 @@ int GlobalRA::coloringRegAlloc() {
   // alignment as well
   fixAlignment();
 
+  // Annotate blocks with profiled frequencies, if any, for spill costs.
+  kernel.getBlockProfile()->run();
+
   {
     TIME_SCOPE(ADDR_FLAG_RA);
 
@@ -9539,10 +9561,24 @@ int GlobalRA::coloringRegAlloc() {
     spillAnalysis = std::make_unique<SpillAnalysis>();
   }
 
+  // Graph coloring keeps liveness, interference and spill iterations alive
+  // at the same time. If half of the memory budget is already used, fall back
+  // to linear scan, which needs much less memory.
+  const unsigned memBudgetLinearScanPercent = 50;
+  MemTracker *memTracker = MemTracker::getActive();
+  bool memBudgetTight =
+      memTracker && memTracker->wouldExceed(0, memBudgetLinearScanPercent);
+
   if (!isReRAPass()) {
     // Global linear scan RA
-    if (builder.getOption(vISA_LinearScan) &&
+    if ((builder.getOption(vISA_LinearScan) || memBudgetTight) &&
         builder.kernel.getInt32KernelAttr(Attributes::ATTR_Target) == VISA_3D) {
+      RA_TRACE({
+        if (memBudgetTight)
+          std::cout << "\t--linear scan RA due to memory budget: "
+                    << (memTracker->getCurrent() >> 10) << "KB used of "
+                    << (memTracker->getBudget() >> 10) << "KB\n";
+      });
       copyMissingAlignment();
       BankConflictPass bc(*this, false);
       LivenessAnalysis liveAnalysis(*this, G4_GRF | G4_INPUT);
@@ -9552,8 +9588,10 @@ int GlobalRA::coloringRegAlloc() {
       LinearScanRA lra(bc, *this, liveAnalysis);
       int success = lra.doLinearScanRA();
       if (success == VISA_SUCCESS) {
-        // TODO: Get correct spillSize from LinearScanRA
-        unsigned spillSize = 0;
+        // Linear scan may have inserted spill/fill intrinsics of its own; the
+        // expansion needs the real spill size to pick the message and to
+        // decide whether a0.2 has to be preserved.
+        unsigned spillSize = lra.getSpillSize();
         expandSpillFillIntrinsics(spillSize);
         assignRegForAliasDcl();
         computePhyReg();
@@ -9681,6 +9719,8 @@ int GlobalRA::coloringRegAlloc() {
         builder.phyregpool.getGreg(0), 0);
   }
   bool rematDone = false, alignedScalarSplitDone = false;
+  bool liveThroughSplitDone = false;
+  unsigned rematIterNo = 0;
   bool reserveSpillReg = false;
   VarSplit splitPass(*this);
   DynPerfModel perfModel(kernel);
@@ -9838,14 +9878,24 @@ int GlobalRA::coloringRegAlloc() {
         bool rerunGRA = false;
         bool globalSplitChange = false;
 
-        if (!rematDone && rematOn) {
+        bool rematChanges = false;
+        // Remat runs on first failing iteration and, with -rematAllIters,
+        // once on each later failing iteration before spill code is
+        // inserted, as earlier spill code changes what is worth recomputing.
+        bool runRematThisIter =
+            !rematDone ||
+            (kernel.getOption(vISA_RematAllIters) && !reserveSpillReg &&
+             rematIterNo != iterationNo);
+        if (runRematThisIter && rematOn) {
           RA_TRACE(std::cout << "\t--rematerialize\n");
           Rematerialization remat(kernel, liveAnalysis, coloring, rpe, *this);
           remat.run();
           rematDone = true;
+          rematIterNo = iterationNo;
 
           // Re-run GRA loop only if remat caused changes to IR
-          rerunGRA |= remat.getChangesMade();
+          rematChanges = remat.getChangesMade();
+          rerunGRA |= rematChanges;
         }
 
         if (kernel.getOption(vISA_SplitGRFAlignedScalar) && !fastCompile &&
@@ -9858,6 +9908,19 @@ int GlobalRA::coloringRegAlloc() {
           rerunGRA |= split.getChangesMade();
         }
 
+        if (iterationNo == 0 && !liveThroughSplitDone && !fastCompile &&
+            !kernel.getOption(vISA_Debug) &&
+            !kernel.getOption(vISA_FastSpill) &&
+            kernel.getOption(vISA_DoSplitOnSpill) &&
+            kernel.getOption(vISA_SplitLiveThroughLoops)) {
+          RA_TRACE(std::cout << "\t--split live-through vars around loops\n");
+          LoopVarSplit loopSplit(kernel, &coloring, &liveAnalysis);
+          liveThroughSplitDone = true;
+
+          // Re-run GRA loop so coloring can spill loop part of split vars
+          rerunGRA |= loopSplit.splitLiveThrough(rpe);
+        }
+
         // Calculate the spill caused by send to decide if global splitting is
         // required or not
         for (auto spilled : coloring.getSpilledLiveRanges()) {
@@ -9883,8 +9946,9 @@ int GlobalRA::coloringRegAlloc() {
           globalSplitChange = true;
         }
 
-        if (iterationNo == 0 && (rerunGRA || globalSplitChange ||
-                                 kernel.getOption(vISA_forceBCR))) {
+        if ((iterationNo == 0 && (rerunGRA || globalSplitChange ||
+                                  kernel.getOption(vISA_forceBCR))) ||
+            (iterationNo > 0 && rematChanges)) {
           if (kernel.getOption(vISA_forceBCR)) {
             kernel.getOptions()->setOption(vISA_forceBCR, false);
           }
@@ -418,6 +418,13 @@ class Interference {
 
   unsigned int denseMatrixLimit = 0;
 
+  // Memory tracker of the current compile, charged for the dense matrix.
+  MemTracker *memTracker = nullptr;
+
+  size_t getDenseMatrixBytes() const {
+    return (size_t)rowSize * (size_t)maxId * sizeof(uint32_t);
+  }
+
   static void updateLiveness(SparseBitSet &live, uint32_t id, bool val) {
     live.set(id, val);
   }
@@ -509,6 +516,8 @@ public:
 
   ~Interference() {
     if (useDenseMatrix()) {
+      if (matrix && memTracker)
+        memTracker->release(getDenseMatrixBytes());
       delete[] matrix;
     }
   }
@@ -529,6 +538,8 @@ public:
     if (useDenseMatrix()) {
       auto N = (size_t)rowSize * (size_t)maxId;
       matrix = new uint32_t[N](); // zero-initialize
+      if (memTracker)
+        memTracker->allocate(getDenseMatrixBytes());
     } else {
       sparseMatrix.resize(maxId);
     }
@@ -1268,6 +1279,7 @@ public:
   void reportSpillInfo(const LivenessAnalysis &liveness,
                        const GraphColor &coloring) const;
   static uint32_t getRefCount(int loopNestLevel);
+  static uint32_t getRefCount(const G4_Kernel &kernel, const G4_BB *bb);
   bool isReRAPass();
   void updateSubRegAlignment(G4_SubReg_Align subAlign);
   bool isChannelSliced();
@@ -23,7 +23,8 @@ llvm::json::Value PERF_STATS::toJSON() {
     {"numGRFSpillFill", numGRFSpillFillWeighted},
     {"GRFSpillSize", spillMemUsed},
     {"numCycles", numCycles},
-    {"maxGRFPressure", maxGRFPressure}
+    {"maxGRFPressure", maxGRFPressure},
+    {"peakMemoryKB", peakMemoryKB}
   };
 }
 
@@ -54,6 +55,11 @@ llvm::json::Value PERF_STATS_VERBOSE::toJSON() {
     jsonObject.insert({"normIntfNum", normIntfNum});
     jsonObject.insert({"augIntfNum", augIntfNum});
   }
+  if (loopFetchSpanBefore) {
+    jsonObject.insert({"numColdBBsSunk", numColdBBsSunk});
+    jsonObject.insert({"loopFetchSpanBefore", loopFetchSpanBefore});
+    jsonObject.insert({"loopFetchSpanAfter", loopFetchSpanAfter});
+  }
 
   return jsonObject;
 }
\ No newline at end of file
@@ -11,6 +11,7 @@ SPDX-License-Identifier: MIT
 #include "BuildIR.h"
 #include "FlowGraph.h"
 #include "LocalDataflow.h"
+#include "Timer.h"
 #include <algorithm>
 #include <unordered_map>
 #include <vector>
@@ -470,6 +471,7 @@ static void processWriteOpnds(G4_BB *BB, G4_INST *Inst,
 }
 
 void FlowGraph::localDataFlowAnalysis() {
+  TIME_SCOPE(LOCAL_DATAFLOW);
   for (auto BB : BBs) {
     LocalLivenessInfo LLI(!BB->isAllLaneActive());
     for (auto I = BB->rbegin(), E = BB->rend(); I != E; ++I) {
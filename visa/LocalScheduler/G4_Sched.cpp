@@ -10,6 +10,7 @@ SPDX-License-Identifier: MIT
 #include "../PointsToAnalysis.h"
 #include "LocalScheduler_G4IR.h"
 #include "Passes/AccSubstitution.hpp"
+#include "Passes/BlockProfile.hpp"
 
 #include "llvm/Support/Allocator.h"
 
@@ -562,6 +563,7 @@ bool preRA_Scheduler::run() {
   auto LT = LatencyTable::createLatencyTable(*kernel.fg.builder);
   SchedConfig config(SchedCtrl);
   RegisterPressure rp(kernel, rpe);
+  kernel.getBlockProfile()->run();
   // skip extreme test cases that scheduling does not good
   // if (kernel.fg.getNumBB() >= 10000 && rp.rpe->getMaxRP() >= 800)
   //   return false;
@@ -599,6 +601,12 @@ bool preRA_Scheduler::run() {
     BB_Scheduler S(kernel, ddd, rp, config, *LT);
 
     Changed |= S.scheduleBlockForPressure(MaxPressure, Threshold);
+    // Hiding latency costs pressure and compile time, neither pays off in a
+    // block the profile says never runs.
+    if (bb->isProfiledCold()) {
+      SCHED_DUMP(std::cerr << "Skip latency scheduling of cold block\n");
+      continue;
+    }
     Changed |= S.scheduleBlockForLatency(MaxPressure, Changed, 0);
   }
   if (kernel.getOptions()->getOption(vISA_PreSchedGRFPressure)) {
@@ -177,6 +177,9 @@ public:
   std::vector<Loop *> getTopLoops();
   Loop *getInnerMostLoop(const G4_BB *);
   void computePreheaders();
+  // Returns the pre-header of loop, creating one if needed. Returns nullptr
+  // if SIMD CF prevents that.
+  G4_BB *getPreheader(Loop *loop);
 
 private:
   std::vector<Loop *> topLoops;
@@ -203,7 +206,6 @@ private:
   void populateLoop(BackEdge &);
   void computeLoopTree();
   void addLoop(Loop *newLoop, Loop *aParent);
-  G4_BB *getPreheader(Loop *loop);
   void computeInnermostLoops();
 };
 } // namespace vISA
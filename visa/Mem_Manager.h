@@ -34,6 +34,95 @@ private:
   vISA::ArenaManager _arenaManager;
 };
 
+// Arena based memory pool that recycles freed blocks through per-size free
+// lists. Blocks are only returned to the system when the pool is destroyed.
+// Meant for containers that keep inserting and erasing small nodes (e.g. the
+// def-use edge lists of G4_INST), where a plain arena would keep growing.
+class Mem_Pool {
+public:
+  Mem_Pool(size_t defaultArenaSize) : _mem(defaultArenaSize) {}
+
+  void *alloc(size_t size) {
+    size_t bucket = getBucket(size);
+    if (bucket >= NumBuckets)
+      return _mem.alloc(size);
+    if (FreeBlock *block = _freeLists[bucket]) {
+      _freeLists[bucket] = block->next;
+      return block;
+    }
+    return _mem.alloc(getBucketSize(bucket));
+  }
+
+  void free(void *p, size_t size) {
+    size_t bucket = getBucket(size);
+    if (!p || bucket >= NumBuckets)
+      return;
+    FreeBlock *block = static_cast<FreeBlock *>(p);
+    block->next = _freeLists[bucket];
+    _freeLists[bucket] = block;
+  }
+
+private:
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  // Blocks up to NumBuckets * 8 bytes are recycled, larger ones are left to
+  // the arena.
+  static constexpr size_t NumBuckets = 8;
+  static size_t getBucket(size_t size) {
+    return size == 0 ? 0 : (size - 1) / ArenaHeader::defaultAlign;
+  }
+  static size_t getBucketSize(size_t bucket) {
+    return (bucket + 1) * ArenaHeader::defaultAlign;
+  }
+
+  Mem_Manager _mem;
+  FreeBlock *_freeLists[NumBuckets] = {};
+};
+
+// std allocator over a shared Mem_Pool. Unlike std_arena_based_allocator,
+// deallocated nodes are reused by later allocations of the same size.
+template <class T> class std_pool_allocator {
+protected:
+  std::shared_ptr<Mem_Pool> mem_pool_ptr;
+
+public:
+  typedef T value_type;
+
+  explicit std_pool_allocator() : mem_pool_ptr(std::make_shared<Mem_Pool>(4096)) {}
+
+  template <class U>
+  std_pool_allocator(const std_pool_allocator<U> &other)
+      : mem_pool_ptr(other.mem_pool_ptr) {}
+
+  template <class U> struct rebind {
+    typedef std_pool_allocator<U> other;
+  };
+
+  template <class U> friend class std_pool_allocator;
+
+  T *allocate(std::size_t n) {
+    static_assert(alignof(T) <= ArenaHeader::defaultAlign,
+                  "over-aligned types are not supported");
+    return static_cast<T *>(mem_pool_ptr->alloc(n * sizeof(T)));
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    mem_pool_ptr->free(p, n * sizeof(T));
+  }
+
+  template <class U>
+  bool operator==(const std_pool_allocator<U> &other) const {
+    return mem_pool_ptr == other.mem_pool_ptr;
+  }
+
+  template <class U>
+  bool operator!=(const std_pool_allocator<U> &other) const {
+    return !operator==(other);
+  }
+};
+
 template <class T> class std_arena_based_allocator {
 protected:
   std::shared_ptr<Mem_Manager> mem_manager_ptr;
@@ -16,6 +16,7 @@ SPDX-License-Identifier: MIT
 #include "DebugInfo.h"
 #include "FlowGraph.h"
 #include "Passes/AccSubstitution.hpp"
+#include "Passes/BlockLayout.hpp"
 #include "PointsToAnalysis.h"
 #include "Passes/InstCombine.hpp"
 #include "Passes/LVN.hpp"
@@ -131,6 +132,11 @@ void Optimizer::insertFallThroughJump() {
   }
 }
 
+void Optimizer::sinkColdBlocks() {
+  BlockLayout layout(kernel);
+  layout.run();
+}
+
 void Optimizer::regAlloc() {
 
   fg.prepareTraversal();
@@ -1409,6 +1415,7 @@ void Optimizer::initOptimizations() {
   INITIALIZE_PASS(regAlloc, vISA_EnableAlways, TimerID::TOTAL_RA);
   INITIALIZE_PASS(removeLifetimeOps, vISA_EnableAlways, TimerID::MISC_OPTS);
   INITIALIZE_PASS(postRA_HWWorkaround, vISA_EnableAlways, TimerID::MISC_OPTS);
+  INITIALIZE_PASS(sinkColdBlocks, vISA_SinkColdBlocks, TimerID::MISC_OPTS);
   INITIALIZE_PASS(removeRedundMov, vISA_removeRedundMov, TimerID::MISC_OPTS);
   INITIALIZE_PASS(removeEmptyBlocks, vISA_EnableAlways, TimerID::MISC_OPTS);
   INITIALIZE_PASS(insertFallThroughJump, vISA_EnableAlways, TimerID::MISC_OPTS);
@@ -1952,6 +1959,9 @@ int Optimizer::optimization() {
   // HW workaround after RA
   runPass(PI_postRA_HWWorkaround);
 
+  // move cold blocks out of hot loops
+  runPass(PI_sinkColdBlocks);
+
   //
   // if a fall-through BB does not immediately follow its predecessor
   // in the code layout, then insert a jump-to-fall-through in the predecessor
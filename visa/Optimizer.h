@@ -114,6 +114,7 @@ class Optimizer {
   void cselPeepHoleOpt();
   void regAlloc();
   void insertFallThroughJump();
+  void sinkColdBlocks();
   void reverseOffsetProp(AddrSubReg_Node addrRegInfo[8], int subReg,
                          unsigned int srcNum, INST_LIST_ITER lastIter,
                          INST_LIST_ITER iend);
@@ -348,6 +349,7 @@ public:
     PI_HWConformityChk,     // always
     PI_preRA_HWWorkaround,  // always, each WA under specific control
     PI_postRA_HWWorkaround, // always, each WA under specific control
+    PI_sinkColdBlocks,
     PI_preRA_Schedule,
     PI_regAlloc,          // always
     PI_removeLifetimeOps, // always
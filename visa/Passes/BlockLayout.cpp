@@ -0,0 +1,173 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2023 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "BlockLayout.hpp"
+#include "BlockProfile.hpp"
+#include "../BuildIR.h"
+#include "../G4_Kernel.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+using namespace vISA;
+
+static void collectLoops(Loop *loop, std::vector<Loop *> &loops) {
+  loops.push_back(loop);
+  for (auto nested : loop->immNested) {
+    collectLoops(nested, loops);
+  }
+}
+
+bool BlockLayout::isCold(G4_BB *bb, const LayoutMap &layout,
+                         const std::vector<LoopRange> &loopRanges) {
+  if (bb->hasProfileFreq()) {
+    return bb->isProfiledCold();
+  }
+
+  Loop *bbLoop = kernel.fg.getLoops().getInnerMostLoop(bb);
+  unsigned bbLevel = bbLoop ? bbLoop->getNestingLevel() : 0;
+  unsigned pos = layout.at(bb);
+  for (auto &range : loopRanges) {
+    if (range.first < pos && pos < range.last && range.level > bbLevel &&
+        !range.loop->contains(bb)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns true if bb can be moved anywhere in the layout without changing
+// control flow: nothing falls into it and it falls into nothing.
+bool BlockLayout::canMove(G4_BB *bb) const {
+  if (bb->empty() || !bb->front()->isLabel() || bb->isDivergent()) {
+    return false;
+  }
+  G4_Operand *label = bb->front()->getSrc(0);
+
+  G4_INST *last = bb->back();
+  for (auto inst : *bb) {
+    if (inst != last && inst->isFlowControl()) {
+      return false;
+    }
+  }
+  if (last->isFlowControl()) {
+    if (last->opcode() != G4_jmpi || last->getPredicate() ||
+        !last->getSrc(0)->isLabel() ||
+        kernel.fg.isIndirectJmpTarget(last)) {
+      return false;
+    }
+  } else if (!last->isEOT()) {
+    return false;
+  }
+
+  // Every predecessor has to reach bb by a jump, including the physical one.
+  for (auto pred : bb->Preds) {
+    if (pred->empty() || pred->back()->opcode() != G4_jmpi ||
+        pred->back()->getSrc(0) != label) {
+      return false;
+    }
+  }
+  G4_BB *physPred = bb->getPhysicalPred();
+  if (!physPred || physPred->empty()) {
+    return false;
+  }
+  G4_INST *physPredLast = physPred->back();
+  bool physPredFallsThrough =
+      !physPredLast->isEOT() &&
+      !(physPredLast->opcode() == G4_jmpi && !physPredLast->getPredicate());
+  return !physPredFallsThrough;
+}
+
+unsigned BlockLayout::getLoopFetchSpan() {
+  std::vector<Loop *> allLoops;
+  for (auto top : kernel.fg.getLoops().getTopLoops()) {
+    collectLoops(top, allLoops);
+  }
+
+  unsigned span = 0;
+  for (auto loop : allLoops) {
+    if (!loop->immNested.empty()) {
+      continue;
+    }
+    bool inLoopRange = false;
+    unsigned numRemaining = loop->getBBSize();
+    for (auto bb : kernel.fg) {
+      bool inLoop = loop->contains(bb);
+      inLoopRange |= inLoop;
+      if (inLoopRange) {
+        span += (unsigned)bb->size();
+      }
+      if (inLoop && --numRemaining == 0) {
+        break;
+      }
+    }
+  }
+  return span;
+}
+
+void BlockLayout::run() {
+  FlowGraph &fg = kernel.fg;
+  // Subroutines must stay contiguous, keep it simple and leave kernels with
+  // calls alone.
+  if (fg.size() < 3 || fg.getNumFuncs() != 0 || fg.getHasStackCalls() ||
+      fg.getIsStackCallFunc()) {
+    return;
+  }
+
+  kernel.getBlockProfile()->run();
+  fg.setPhysicalPredSucc();
+
+  LayoutMap layout;
+  unsigned pos = 0;
+  for (auto bb : fg) {
+    layout[bb] = pos++;
+  }
+
+  // The fetch span is O(loops * blocks), only compute it for the stats.
+  bool dumpStats = kernel.getOption(vISA_DumpPerfStatsVerbose);
+  auto &stats = fg.builder->getJitInfo()->statsVerbose;
+  if (dumpStats) {
+    stats.loopFetchSpanBefore = getLoopFetchSpan();
+  }
+
+  std::vector<Loop *> allLoops;
+  for (auto top : fg.getLoops().getTopLoops()) {
+    collectLoops(top, allLoops);
+  }
+  std::vector<LoopRange> loopRanges;
+  for (auto loop : allLoops) {
+    LoopRange range{loop, loop->getNestingLevel(), UINT_MAX, 0};
+    for (auto loopBB : loop->getBBs()) {
+      range.first = std::min(range.first, layout.at(loopBB));
+      range.last = std::max(range.last, layout.at(loopBB));
+    }
+    loopRanges.push_back(range);
+  }
+
+  std::vector<BB_LIST_ITER> coldBBs;
+  for (auto it = std::next(fg.begin()), end = std::prev(fg.end()); it != end;
+       ++it) {
+    if (isCold(*it, layout, loopRanges) && canMove(*it)) {
+      coldBBs.push_back(it);
+    }
+  }
+
+  // Keep the relative order of the cold blocks.
+  for (auto it : coldBBs) {
+    G4_BB *bb = *it;
+    fg.erase(it);
+    fg.push_back(bb);
+  }
+
+  if (dumpStats) {
+    stats.numColdBBsSunk = (uint32_t)coldBBs.size();
+    stats.loopFetchSpanAfter =
+        coldBBs.empty() ? stats.loopFetchSpanBefore : getLoopFetchSpan();
+  }
+}
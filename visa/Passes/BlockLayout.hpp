@@ -0,0 +1,67 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2023 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef _BLOCKLAYOUT_H
+#define _BLOCKLAYOUT_H
+
+#include "../G4_IR.hpp"
+#include "../FlowGraph.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace vISA {
+
+// Moves cold blocks to the end of the kernel so that hot loops stay compact
+// in the instruction cache.
+//
+// A block is cold if the block profile (-blockProfile) says it never runs or,
+// without profile data for it, if it is laid out inside the range of a loop
+// that is nested deeper than the block itself. Such blocks are loop exit
+// paths (error handling, early returns, ...) and run at most once per
+// execution of the loop they interrupt.
+//
+// Only blocks that neither fall through nor are fallen into are moved, i.e.
+// blocks entered by uniform jmpi only and left by an unconditional jmpi or
+// EOT. Moving them changes no control flow and needs no new instruction, and
+// keeps goto/join and other SIMD control flow untouched. The kernel may end
+// with a moved block, i.e. with a jmpi rather than EOT, which is why the pass
+// only runs with -sinkcoldbb.
+class BlockLayout {
+  G4_Kernel &kernel;
+
+public:
+  BlockLayout(G4_Kernel &K) : kernel(K) {}
+
+  BlockLayout(const BlockLayout &) = delete;
+  virtual ~BlockLayout() = default;
+
+  void run();
+
+private:
+  using LayoutMap = std::unordered_map<const G4_BB *, unsigned>;
+  // layout positions of the first and last block of a loop
+  struct LoopRange {
+    Loop *loop;
+    unsigned level;
+    unsigned first;
+    unsigned last;
+  };
+
+  bool isCold(G4_BB *bb, const LayoutMap &layout,
+              const std::vector<LoopRange> &loopRanges);
+  bool canMove(G4_BB *bb) const;
+  // Sum over innermost loops of the number of instructions laid out between
+  // the first and last block of the loop, i.e. the code fetched while
+  // running the loop.
+  unsigned getLoopFetchSpan();
+};
+
+} // namespace vISA
+
+#endif // _BLOCKLAYOUT_H
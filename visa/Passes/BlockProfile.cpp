@@ -0,0 +1,124 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2023 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "BlockProfile.hpp"
+#include "../G4_Kernel.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+using namespace vISA;
+
+// Reads the section of the profile that belongs to this kernel into counts.
+// Returns false if there is none or if it was collected for a different hash.
+bool BlockProfile::readProfile(const char *path) {
+  std::ifstream input(path);
+  if (!input) {
+    return false;
+  }
+
+  uint64_t kernelHash = kernel.getOptions()->getuInt64Option(vISA_HashVal);
+  bool inSection = false;
+  bool found = false;
+  std::string line;
+  while (std::getline(input, line)) {
+    std::istringstream ss(line);
+    std::string first;
+    if (!(ss >> first) || first[0] == '#') {
+      continue;
+    }
+
+    if (first == "kernel") {
+      std::string name, hash;
+      ss >> name >> hash;
+      inSection = name == kernel.getName();
+      if (inSection && !hash.empty() && kernelHash != 0 &&
+          std::strtoull(hash.c_str(), nullptr, 16) != kernelHash) {
+        // Profile of another version of this kernel.
+        counts.clear();
+        return false;
+      }
+      found |= inSection;
+      continue;
+    }
+
+    if (!inSection) {
+      continue;
+    }
+    uint64_t count = 0;
+    if (ss >> count) {
+      counts[(int)std::strtol(first.c_str(), nullptr, 10)] = count;
+    }
+  }
+  return found && !counts.empty();
+}
+
+void BlockProfile::clear() {
+  for (auto bb : kernel.fg) {
+    bb->setProfileFreq(-1.0f);
+  }
+}
+
+bool BlockProfile::run() {
+  clear();
+
+  if (!profileRead) {
+    profileRead = true;
+    const char *path = kernel.getOptions()->getOptionCstr(vISA_BlockProfile);
+    if (path && *path != '\0' && !readProfile(path)) {
+      counts.clear();
+    }
+  }
+  if (counts.empty() || kernel.fg.empty()) {
+    return false;
+  }
+
+  std::unordered_map<G4_BB *, uint64_t> bbCounts;
+  std::unordered_set<int> matched;
+  for (auto bb : kernel.fg) {
+    for (auto inst : *bb) {
+      if (!inst->isVISAIdValid()) {
+        continue;
+      }
+      auto it = counts.find(inst->getVISAId());
+      if (it == counts.end()) {
+        continue;
+      }
+      matched.insert(it->first);
+      uint64_t &bbCount = bbCounts[bb];
+      bbCount = std::max(bbCount, it->second);
+    }
+  }
+
+  // If most of the profiled instructions are gone, the input changed since
+  // profiling and the counts can not be trusted.
+  auto entryIt = bbCounts.find(kernel.fg.getEntryBB());
+  if (matched.size() * 2 < counts.size() || entryIt == bbCounts.end() ||
+      entryIt->second == 0) {
+    if (kernel.getOption(vISA_RATrace)) {
+      std::cout << "\t--ignoring stale block profile for " << kernel.getName()
+                << "\n";
+    }
+    return false;
+  }
+
+  float entryCount = (float)entryIt->second;
+  unsigned numCold = 0;
+  for (auto &bbCount : bbCounts) {
+    bbCount.first->setProfileFreq((float)bbCount.second / entryCount);
+    numCold += bbCount.first->isProfiledCold();
+  }
+  if (kernel.getOption(vISA_RATrace)) {
+    std::cout << "\t--block profile for " << kernel.getName() << ": "
+              << bbCounts.size() << " of " << kernel.fg.size()
+              << " blocks annotated, " << numCold << " cold\n";
+  }
+  return true;
+}
@@ -0,0 +1,65 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2023 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef _BLOCKPROFILE_H
+#define _BLOCKPROFILE_H
+
+#include "../G4_IR.hpp"
+#include "../FlowGraph.h"
+
+#include <string>
+#include <unordered_map>
+
+namespace vISA {
+
+// Annotates basic blocks with execution frequencies from a profiling run,
+// given with -blockProfile <file>. The file is plain text:
+//
+//   # comment
+//   kernel <name> [<hash>]
+//   <vISA instruction id> <execution count>
+//   ...
+//
+// Counts are keyed by vISA instruction id (the index of the instruction in
+// the .isa/.visaasm input) rather than by G4_BB id, so they still apply
+// after the CFG changed between profiling and the current compile: the count
+// of a block is the largest count of its instructions. Frequencies are
+// normalized to the entry block, so a loop body that iterated 10 times per
+// thread gets 10, same as the static loop estimate of RA would guess.
+//
+// Without a usable profile (no option, no section for this kernel, hash
+// mismatch, or most ids no longer present) nothing is annotated and all users
+// fall back to their static heuristics.
+//
+// The kernel owns one instance (G4_Kernel::getBlockProfile()). The file is
+// read once, and every later run() only maps the counts to the current CFG.
+class BlockProfile {
+  // vISA instruction id -> execution count
+  using CountMap = std::unordered_map<int, uint64_t>;
+
+  G4_Kernel &kernel;
+  bool profileRead = false;
+  CountMap counts;
+
+public:
+  BlockProfile(G4_Kernel &K) : kernel(K) {}
+
+  BlockProfile(const BlockProfile &) = delete;
+
+  // Sets profile frequency of every block of the kernel. Returns false and
+  // clears any previous annotation if there is no usable profile.
+  bool run();
+
+private:
+  bool readProfile(const char *path);
+  void clear();
+};
+
+} // namespace vISA
+
+#endif // _BLOCKPROFILE_H
@@ -3054,7 +3054,8 @@ int regAlloc(IR_Builder &builder, PhyRegPool &regPool, G4_Kernel &kernel) {
       replaceSSO(kernel);
   }
 
-  if (kernel.getOption(vISA_DoSplitOnSpill)) {
+  if (kernel.getOption(vISA_DoSplitOnSpill) ||
+      kernel.getOption(vISA_HoistLoopFills)) {
     // loop computation is done here because we may need to add
     // new preheader BBs. later parts of RA assume no change
     // to CFG structure.
@@ -547,6 +547,11 @@ bool Rematerialization::canRematerialize(G4_SrcRegRegion *src, G4_BB *bb,
       } else if (loopInstToTotalInstRatio > 3.89f)
         return false;
     }
+
+    // Instruction count alone treats a math op like a mov, so also bound
+    // latency added to loops using the platform latency table.
+    if (exceedsLoopLatencyBudget(uniqueDefInst))
+      return false;
   }
 
   if (!inSameLoop) {
@@ -804,9 +809,25 @@ bool Rematerialization::canRematerialize(G4_SrcRegRegion *src, G4_BB *bb,
     return false;
   }
 
+  // Like the remat count, latency budget is spent by non-scalar remats only.
+  if (LT && !inSameLoop && uniqueDefInst->getExecSize() > 1)
+    rematLatencyInLoop += LT->getLatency(uniqueDefInst);
+
   return true;
 }
 
+bool Rematerialization::exceedsLoopLatencyBudget(G4_INST *inst) const {
+  // First remat in loop is always allowed, same as instruction count check.
+  if (!LT || rematLatencyInLoop == 0 || loopLatencyBeforeRemat == 0)
+    return false;
+
+  float latencyRatio = (float)(rematLatencyInLoop + LT->getLatency(inst)) /
+                       (float)loopLatencyBeforeRemat * 100.0f;
+  if (rpe.getMaxRP() < rematRegPressure * 1.4f)
+    return latencyRatio > cRematLoopLatencyPct;
+  return latencyRatio > cRematLoopLatencyPctHighRP;
+}
+
 G4_SrcRegRegion *Rematerialization::rematerialize(G4_SrcRegRegion *src,
                                                   G4_BB *bb,
                                                   const Reference *uniqueDef,
@@ -11,9 +11,11 @@ SPDX-License-Identifier: MIT
 
 #include "FlowGraph.h"
 #include "GraphColor.h"
+#include "LocalScheduler/LatencyTable.h"
 #include "RPE.h"
 #include <list>
 #include <map>
+#include <memory>
 
 namespace vISA {
 // Remat will trigger only for vars that have less than following uses
@@ -62,11 +64,25 @@ private:
   bool samplerHeaderMapPopulated = false;
   unsigned int loopInstsBeforeRemat = 0;
   unsigned int totalInstsBeforeRemat = 0;
+  // Sum of latencies of loop instructions before remat and of operations
+  // remat'd in to loops. Used to bound extra latency added to loops when
+  // remat runs on every failing iteration (-rematAllIters), LT is null
+  // otherwise.
+  uint64_t loopLatencyBeforeRemat = 0;
+  uint64_t rematLatencyInLoop = 0;
+  std::unique_ptr<LatencyTable> LT;
   RPE &rpe;
 
   static const unsigned int cRematLoopRegPressure128GRF = 85;
   static const unsigned int cRematRegPressure128GRF = 120;
 
+  // Max latency remats may add to loops, in percent of the latency of loop
+  // instructions before remat, when max RP is moderate and when it's high.
+  // Loop latency is dominated by sends, so a remat'd ALU op weighs less here
+  // than in the instruction count ratio and math ops weigh more.
+  static constexpr float cRematLoopLatencyPct = 1.0f;
+  static constexpr float cRematLoopLatencyPctHighRP = 2.5f;
+
   unsigned int rematLoopRegPressure = 0;
   unsigned int rematRegPressure = 0;
 
@@ -173,6 +189,7 @@ private:
 
   unsigned int getNumRematsInLoop() const { return numRematsInLoop; }
   void incNumRematsInLoop() { numRematsInLoop++; }
+  bool exceedsLoopLatencyBudget(G4_INST *inst) const;
   bool inSameSubroutine(G4_BB *, G4_BB *);
 
   bool isPartGRFBusyInput(G4_Declare *inputDcl, unsigned int atLexId);
@@ -180,7 +197,11 @@ private:
 public:
   Rematerialization(G4_Kernel &k, const LivenessAnalysis &l, GraphColor &c,
                     RPE &r, GlobalRA &g)
-      : kernel(k), liveness(l), coloring(c), gra(g), rpe(r) {
+      : kernel(k), liveness(l), coloring(c), gra(g),
+        LT(k.getOption(vISA_RematAllIters)
+               ? LatencyTable::createLatencyTable(*k.fg.builder)
+               : nullptr),
+        rpe(r) {
     unsigned numGRFs = k.getNumRegTotal();
     auto scale = [=](unsigned threshold) -> unsigned {
       float ratio = 1.0f - (128 - threshold) / 128.0f;
@@ -222,6 +243,8 @@ public:
         for (auto &inst : *bb) {
           if (!inst->isLabel() && !inst->isPseudoKill()) {
             loopInstsBeforeRemat++;
+            if (LT)
+              loopLatencyBeforeRemat += LT->getLatency(inst);
           }
         }
       }
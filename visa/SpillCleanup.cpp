@@ -11,7 +11,10 @@ SPDX-License-Identifier: MIT
 #include "FlowGraph.h"
 #include "GraphColor.h"
 
+#include <functional>
 #include <list>
+#include <unordered_map>
+#include <unordered_set>
 
 uint32_t computeFillMsgDesc(unsigned int payloadSize, unsigned int offset);
 uint32_t computeSpillMsgDesc(unsigned int payloadSize, unsigned int offset);
@@ -1884,7 +1887,185 @@ void CoalesceSpillFills::removeRedundantWrites() {
   }
 }
 
+void CoalesceSpillFills::hoistLoopInvariantFills() {
+  // Spill code is inserted locally, so a variable that is live across a loop
+  // but spilled gets filled on every iteration. When the loop never writes
+  // the spill slot, the fill produces the same value on every iteration and
+  // can be done once in the loop pre-header instead:
+  //
+  // BB1 (pre-header):
+  //   ...
+  // BB2 (loop):
+  //   FILL_V10 = fill [offset 4, 1 row]   <-- no spill to slot 4 in loop
+  //   add (16) V20 FILL_V10 ...
+  //   (p) jmpi BB2
+  //
+  // is rewritten as:
+  //
+  // BB1 (pre-header):
+  //   ...
+  //   FILL_V10 = fill [offset 4, 1 row]
+  // BB2 (loop):
+  //   add (16) V20 FILL_V10 ...
+  //   (p) jmpi BB2
+  //
+  // This extends live-range of fill temp over the whole loop, so it is only
+  // done when register pressure in the loop leaves room for it.
+  // NoMask WA tracks fills per BB, so leave them in place when it's needed.
+  if (gra.EUFusionNoMaskWANeeded())
+    return;
+
+  auto &loops = kernel.fg.getLoops();
+  if (loops.getTopLoops().empty())
+    return;
+
+  // Fill temp must be written by the fill alone to be hoisted.
+  std::unordered_map<const G4_Declare *, unsigned int> numDefs;
+  for (auto bb : kernel.fg) {
+    for (auto inst : *bb) {
+      auto dst = inst->getDst();
+      if (dst && dst->getTopDcl())
+        numDefs[dst->getTopDcl()->getRootDeclare()]++;
+    }
+  }
+
+  // Per loop info needed to decide whether a fill can be hoisted:
+  // scratch rows written in loop, whether loop has calls, max register
+  // pressure in loop, and number of GRF rows already hoisted over loop.
+  struct LoopInfo {
+    std::unordered_set<unsigned int> spillRows;
+    bool hasCall = false;
+    unsigned int maxRP = 0;
+    unsigned int hoistedRows = 0;
+  };
+  std::unordered_map<Loop *, LoopInfo> loopInfo;
+
+  std::function<void(Loop *)> collectInfo = [&](Loop *loop) {
+    auto &info = loopInfo[loop];
+    for (auto bb : loop->getBBs()) {
+      if (bb->isEndWithCall() || bb->isEndWithFCall())
+        info.hasCall = true;
+      for (auto inst : *bb) {
+        info.maxRP = std::max(info.maxRP, rpe.getRegisterPressure(inst));
+        if (inst->isSpillIntrinsic()) {
+          unsigned int offset = 0, size = 0;
+          getScratchMsgInfo(inst, offset, size);
+          for (unsigned int k = offset; k != (offset + size); k++)
+            info.spillRows.insert(k);
+        }
+      }
+    }
+    for (auto nested : loop->immNested)
+      collectInfo(nested);
+  };
+  for (auto loop : loops.getTopLoops())
+    collectInfo(loop);
+
+  std::function<void(Loop *, unsigned int)> addHoistedRows =
+      [&](Loop *loop, unsigned int rows) {
+        loopInfo[loop].hoistedRows += rows;
+        for (auto nested : loop->immNested)
+          addHoistedRows(nested, rows);
+      };
+
+  auto canHoistOut = [&](Loop *loop, unsigned int offset, unsigned int size) {
+    auto &info = loopInfo[loop];
+    if (info.hasCall)
+      return false;
+    if (info.maxRP + info.hoistedRows + size > highRegPressureForCleanup)
+      return false;
+    for (unsigned int k = offset; k != (offset + size); k++) {
+      if (info.spillRows.count(k))
+        return false;
+    }
+    // Pre-headers were created before RA, so this doesn't change the CFG.
+    return loops.getPreheader(loop) != nullptr;
+  };
+
+  auto r0 = kernel.fg.builder->getBuiltinR0()->getRootDeclare();
+  unsigned int numHoisted = 0;
+
+  for (auto bb : kernel.fg) {
+    auto innerMost = loops.getInnerMostLoop(bb);
+    if (!innerMost)
+      continue;
+
+    for (auto instIt = bb->begin(); instIt != bb->end();) {
+      auto inst = (*instIt);
+      if (!inst->isFillIntrinsic() || inst->getPredicate() ||
+          !inst->isWriteEnableInst() || inst->asFillIntrinsic()->isOffBP() ||
+          isGRFAssigned(inst->getDst())) {
+        ++instIt;
+        continue;
+      }
+
+      auto header = inst->asFillIntrinsic()->getHeader();
+      auto dstDcl = inst->getDst()->getTopDcl()->getRootDeclare();
+      if ((!header->isNullReg() && header->getTopDcl() &&
+           header->getTopDcl()->getRootDeclare() != r0) ||
+          dstDcl->getAddressed() || numDefs[dstDcl] != 1) {
+        ++instIt;
+        continue;
+      }
+
+      unsigned int offset = 0, size = 0;
+      getScratchMsgInfo(inst, offset, size);
+
+      // Hoist out of as many enclosing loops as possible.
+      Loop *target = nullptr;
+      for (auto loop = innerMost; loop && canHoistOut(loop, offset, size);
+           loop = loop->parent) {
+        target = loop;
+      }
+
+      if (!target) {
+        ++instIt;
+        continue;
+      }
+
+      auto preheader = loops.getPreheader(target);
+      auto insertIt = preheader->end();
+      if (!preheader->empty() && preheader->back()->isCFInst())
+        --insertIt;
+      preheader->insertBefore(insertIt, inst, false);
+      instIt = bb->erase(instIt);
+
+      addHoistedRows(target, size);
+      numHoisted++;
+    }
+  }
+
+  if (kernel.getOption(vISA_RATrace) && numHoisted > 0)
+    std::cout << "\t--hoisted " << numHoisted << " fills out of loops\n";
+}
+
+// Return <spills, fills> weighted by profiled frequency or loop nesting level
+// of the block they are in. This approximates number of spill/fill messages
+// executed.
+std::pair<uint64_t, uint64_t> CoalesceSpillFills::getDynamicSpillFillCount() {
+  auto &loops = kernel.fg.getLoops();
+  uint64_t numSpills = 0, numFills = 0;
+  for (auto bb : kernel.fg) {
+    auto innerMost = loops.getInnerMostLoop(bb);
+    uint64_t weight = bb->hasProfileFreq()
+                          ? GlobalRA::getRefCount(kernel, bb)
+                          : GlobalRA::getRefCount(
+                                innerMost ? innerMost->getNestingLevel() : 0);
+    for (auto inst : *bb) {
+      if (inst->isSpillIntrinsic())
+        numSpills += weight;
+      else if (inst->isFillIntrinsic())
+        numFills += weight;
+    }
+  }
+  return std::make_pair(numSpills, numFills);
+}
+
 void CoalesceSpillFills::run() {
+  std::pair<uint64_t, uint64_t> before;
+  if (kernel.getOption(vISA_RATrace))
+    before = getDynamicSpillFillCount();
+
   removeRedundantSplitMovs();
 
   fills();
@@ -1895,8 +2076,18 @@ void CoalesceSpillFills::run() {
 
   removeRedundantWrites();
 
+  if (kernel.getOption(vISA_HoistLoopFills))
+    hoistLoopInvariantFills();
+
   fixSendsSrcOverlap();
 
+  if (kernel.getOption(vISA_RATrace)) {
+    auto after = getDynamicSpillFillCount();
+    std::cout << "\t--loop weighted spills: " << before.first << " -> "
+              << after.first << ", fills: " << before.second << " -> "
+              << after.second << "\n";
+  }
+
   kernel.dumpToFile("after.spillCleanup." + std::to_string(iterNo));
 }
 
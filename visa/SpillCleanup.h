@@ -95,6 +95,8 @@ private:
   void populateSendDstDcl();
   void spillFillCleanup();
   void removeRedundantWrites();
+  void hoistLoopInvariantFills();
+  std::pair<uint64_t, uint64_t> getDynamicSpillFillCount();
 
 public:
   CoalesceSpillFills(G4_Kernel &k, LivenessAnalysis &l, GraphColor &g,
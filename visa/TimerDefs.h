@@ -33,3 +33,4 @@ DEF_TIMER(VISA_BUILDER_CREATE_OPND, "VB_Create_Operand")
 DEF_TIMER(VISA_BUILDER_IR_CONSTRUCTION, "VB_IR_Construction")
 DEF_TIMER(LIVENESS, "liveness")
 DEF_TIMER(RPE, "Reg Pressure Estimate")
+DEF_TIMER(LOCAL_DATAFLOW, "Local_Dataflow")
@@ -874,7 +874,7 @@ bool VarSplitPass::isSplitVarLocal(G4_Declare *dcl) {
 
 LoopVarSplit::LoopVarSplit(G4_Kernel &k, GraphColor *c,
                            const LivenessAnalysis *liveAnalysis)
-    : kernel(k), coloring(c), references(k) {
+    : kernel(k), coloring(c), references(k), liveness(liveAnalysis) {
   for (auto spill : coloring->getSpilledLiveRanges()) {
     spilledDclSet.insert(spill->getDcl());
   }
@@ -926,6 +926,174 @@ void LoopVarSplit::run() {
   }
 }
 
+bool LoopVarSplit::canSplitLiveThrough(Loop &loop) {
+  // Copies are inserted at end of pre-header and at start of the only loop
+  // exit. Every path in to exit must come from loop so that copy back to
+  // original variable never clobbers a value defined elsewhere.
+  if (!loop.preHeader || loop.subCalls)
+    return false;
+
+  if (loop.preHeader->size() > 0 && loop.preHeader->back()->isCFInst())
+    return false;
+
+  if (loop.getLoopExits().size() != 1)
+    return false;
+
+  auto exitBB = loop.getLoopExits().front();
+  for (auto pred : exitBB->Preds) {
+    if (!loop.contains(pred))
+      return false;
+  }
+
+  return true;
+}
+
+// Split variables that are live through a loop without being referenced
+// in it, when register pressure in the loop exceeds available GRFs:
+//
+// V = ...
+// preheader:
+//   LIVETHRU_V = V
+// loop:
+//   ... (no reference to V)
+// exit:
+//   V = LIVETHRU_V
+//   ... = V
+//
+// V is no longer live in the loop. Its loop part LIVETHRU_V has only 2
+// references, both outside the loop, so it is a cheap spill candidate and
+// coloring can spill it instead of variables referenced in the loop.
+// fullRPE is register pressure computed before coloring, ie including
+// spilled variables. Returns true if IR was changed.
+bool LoopVarSplit::splitLiveThrough(RPE &fullRPE) {
+  if (spilledDclSet.empty() || !liveness->livenessClass(G4_GRF))
+    return false;
+
+  auto &gra = coloring->getGRA();
+  auto numVars = coloring->getNumVars();
+  auto lrs = coloring->getLiveRanges();
+  unsigned int numRegTotal = kernel.getNumRegTotal();
+
+  // rows already made free in a loop by splitting around it or its parent
+  std::unordered_map<Loop *, unsigned int> freedRows;
+  // loops each variable was split around
+  std::unordered_map<G4_Declare *, std::vector<Loop *>> splitLoops;
+  bool changesMade = false;
+
+  std::function<void(Loop *, unsigned int)> addFreedRows =
+      [&](Loop *loop, unsigned int rows) {
+        freedRows[loop] += rows;
+        for (auto nested : loop->immNested)
+          addFreedRows(nested, rows);
+      };
+
+  auto splitAround = [&](Loop *loop) {
+    unsigned int maxRP = 0;
+    std::unordered_set<const G4_Declare *> refsInLoop;
+    bool hasSpilledRef = false;
+    for (auto bb : loop->getBBs()) {
+      for (auto inst : *bb) {
+        maxRP = std::max(maxRP, fullRPE.getRegisterPressure(inst));
+        auto dst = inst->getDst();
+        if (dst && dst->getTopDcl())
+          refsInLoop.insert(dst->getTopDcl()->getRootDeclare());
+        for (unsigned int i = 0; i != inst->getNumSrc(); ++i) {
+          auto src = inst->getSrc(i);
+          if (src && src->isSrcRegRegion() && src->getTopDcl())
+            refsInLoop.insert(src->getTopDcl()->getRootDeclare());
+        }
+      }
+    }
+
+    for (auto dcl : refsInLoop) {
+      if (spilledDclSet.count(const_cast<G4_Declare *>(dcl))) {
+        hasSpilledRef = true;
+        break;
+      }
+    }
+
+    // only split around loops where coloring had to spill something
+    // referenced in the loop.
+    if (!hasSpilledRef || maxRP <= numRegTotal + freedRows[loop])
+      return;
+
+    if (!canSplitLiveThrough(*loop))
+      return;
+
+    unsigned int excess = maxRP - numRegTotal - freedRows[loop];
+    auto header = loop->getHeader();
+
+    std::vector<G4_Declare *> candidates;
+    for (unsigned int i = 0; i != numVars; ++i) {
+      auto dcl = lrs[i]->getDcl();
+      if (dcl->getRegFile() != G4_GRF || dcl->getAddressed() ||
+          dcl->isInput() || dcl->getRegVar()->getPhyReg() ||
+          kernel.fg.isPseudoDcl(dcl) || spilledDclSet.count(dcl) ||
+          gra.splitResults.count(dcl) || refsInLoop.count(dcl))
+        continue;
+
+      if (!liveness->isLiveAtEntry(header, i))
+        continue;
+
+      bool nested = false;
+      for (auto splitLoop : splitLoops[dcl]) {
+        if (loop->fullSubset(splitLoop)) {
+          nested = true;
+          break;
+        }
+      }
+      if (nested)
+        continue;
+
+      candidates.push_back(dcl);
+    }
+
+    // largest variables first as they free most GRFs per copy
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](G4_Declare *dcl1, G4_Declare *dcl2) {
+                       return dcl1->getNumRows() > dcl2->getNumRows();
+                     });
+
+    unsigned int freed = 0;
+    for (auto dcl : candidates) {
+      if (freed >= excess)
+        break;
+
+      auto splitDcl = kernel.fg.builder->createTempVar(
+          dcl->getTotalElems(), dcl->getElemType(), gra.getSubRegAlign(dcl),
+          "LIVETHRU", true);
+      gra.copyAlignment(splitDcl, dcl);
+      bool isDefault32bMask =
+          gra.getAugmentationMask(dcl) == AugmentationMasks::Default32Bit;
+
+      // copies are not registered in GlobalRA::splitResults. they must stay
+      // even when split variable spills, as original variable is not
+      // spilled.
+      SplitResults splitData;
+      copy(loop->preHeader, splitDcl, dcl, &splitData, isDefault32bMask);
+      copy(loop->getLoopExits().front(), dcl, splitDcl, &splitData,
+           isDefault32bMask, /*pushBack*/ false);
+
+      splitLoops[dcl].push_back(loop);
+      addFreedRows(loop, dcl->getNumRows());
+      freed += dcl->getNumRows();
+      changesMade = true;
+    }
+  };
+
+  // visit parent loops before nested ones so variables are split around
+  // outermost loop they're live through.
+  std::function<void(Loop *)> visit = [&](Loop *loop) {
+    splitAround(loop);
+    for (auto nested : loop->immNested)
+      visit(nested);
+  };
+  for (auto loop : kernel.fg.getLoops().getTopLoops())
+    visit(loop);
+
+  return changesMade;
+}
+
 std::vector<G4_SrcRegRegion *> LoopVarSplit::getReads(G4_Declare *dcl,
                                                       Loop &loop) {
   std::vector<G4_SrcRegRegion *> reads;
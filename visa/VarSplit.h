@@ -44,6 +44,7 @@ public:
   ~LoopVarSplit() { delete rpe; }
 
   void run();
+  bool splitLiveThrough(RPE &fullRPE);
 
   std::vector<G4_SrcRegRegion *> getReads(G4_Declare *dcl, Loop &loop);
   std::vector<G4_DstRegRegion *> getWrites(G4_Declare *dcl, Loop &loop);
@@ -71,11 +72,13 @@ private:
   G4_Declare *getNewDcl(G4_Declare *dcl1, G4_Declare *dcl2, const Loop &loop);
   std::vector<Loop *> getLoopsToSplitAround(G4_Declare *dcl);
   void adjustLoopMaxPressure(Loop &loop, unsigned int numRows);
+  bool canSplitLiveThrough(Loop &loop);
 
   G4_Kernel &kernel;
   GraphColor *coloring = nullptr;
   RPE *rpe = nullptr;
   VarReferences references;
+  const LivenessAnalysis *liveness = nullptr;
 
   // store set of dcls marked as spill in current RA iteration
   std::unordered_set<G4_Declare *> spilledDclSet;
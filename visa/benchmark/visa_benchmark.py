@@ -0,0 +1,247 @@
+# ========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2023 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+# =========================== end_copyright_notice =============================
+
+# Compile-time and code-quality benchmark for the standalone vISA finalizer.
+#
+# Runs GenX_IR over a corpus of .isa/.visaasm kernels and collects per kernel:
+#   - per-phase timers (TimerDefs.h), written by GenX_IR with -timestats
+#   - peak RSS of the finalizer process and peak arena memory of vISA
+#   - instruction count, spill/fill count, spill size and static cycle
+#     estimate, written by GenX_IR with -dumpVISAJsonStats
+#
+# Corpus layout is one sub-directory per platform, named as accepted by
+# GenX_IR -platform:
+#
+#   <corpus>/XE_HP/foo.visaasm
+#   <corpus>/XE_HPG/bar.isa
+#   ...
+#
+# Results are written as JSON. When a baseline produced by an earlier run is
+# given, results are compared against it and the script exits with non-zero
+# status if any metric regressed by more than its threshold.
+
+import argparse
+import glob
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# Metrics from .stats.json that are compared against baseline.
+STATS_METRICS = {
+    'numAsmCount': 'instCount',
+    'numGRFSpillFill': 'spillFillCount',
+    'GRFSpillSize': 'spillSize',
+    'numCycles': 'staticCycles',
+    'peakMemoryKB': 'peakMemoryKB',
+}
+
+# Default allowed regression per metric, in percent.
+DEFAULT_THRESHOLDS = {
+    'totalTime': 10.0,
+    'peakRSSKB': 10.0,
+    'instCount': 1.0,
+    'spillFillCount': 0.0,
+    'spillSize': 0.0,
+    'staticCycles': 1.0,
+    'peakMemoryKB': 10.0,
+}
+
+# Compile time of tiny kernels is mostly noise, so ignore time regressions
+# below this many seconds.
+MIN_TIME_DELTA = 0.005
+
+
+def RunFinalizer(exe, kernel, platform, extraOptions, workDir):
+    cmd = [exe, os.path.abspath(kernel), '-platform', platform,
+           '-dumpVISAJsonStats', '-timestats'] + extraOptions
+    with open(os.path.join(workDir, 'finalizer.log'), 'w') as log:
+        proc = subprocess.Popen(cmd, cwd=workDir, stdout=log,
+                                stderr=subprocess.STDOUT)
+        # wait4 returns resource usage of the finalizer process alone
+        _, status, usage = os.wait4(proc.pid, 0)
+        if os.WIFEXITED(status):
+            proc.returncode = os.WEXITSTATUS(status)
+        else:
+            proc.returncode = -os.WTERMSIG(status)
+    return proc.returncode, usage.ru_maxrss
+
+
+def ReadTimers(workDir):
+    # -timestats writes TIMER_NAME:seconds lines to timers.<asm name>
+    timers = {}
+    for path in glob.glob(os.path.join(workDir, 'timers.*')):
+        with open(path) as f:
+            for line in f:
+                name, sep, value = line.strip().rpartition(':')
+                if not sep:
+                    continue
+                try:
+                    timers[name] = timers.get(name, 0.0) + float(value)
+                except ValueError:
+                    pass
+    return timers
+
+
+def ReadStats(workDir):
+    # -dumpVISAJsonStats writes {kernel name: {stat: value}} per kernel.
+    # Sum stats over all kernels/functions compiled from one input.
+    stats = {}
+    for path in glob.glob(os.path.join(workDir, '*.stats.json')):
+        with open(path) as f:
+            data = json.load(f)
+        for perKernel in data.values():
+            if isinstance(perKernel, list):
+                perKernel = perKernel[0]
+            for jsonName, name in STATS_METRICS.items():
+                if jsonName in perKernel:
+                    stats[name] = stats.get(name, 0) + perKernel[jsonName]
+    return stats
+
+
+def BenchmarkKernel(exe, kernel, platform, extraOptions, repeat):
+    result = {'platform': platform, 'status': 'ok'}
+    bestTime = None
+    for _ in range(repeat):
+        workDir = tempfile.mkdtemp(prefix='visa_bench_')
+        try:
+            rc, maxRSS = RunFinalizer(exe, kernel, platform, extraOptions,
+                                      workDir)
+            if rc != 0:
+                result['status'] = 'failed ({0})'.format(rc)
+                return result
+
+            timers = ReadTimers(workDir)
+            totalTime = timers.get('TOTAL', 0.0)
+            # Keep the fastest run, timers of slower runs are mostly noise.
+            if bestTime is None or totalTime < bestTime:
+                bestTime = totalTime
+                result['timers'] = timers
+                result['totalTime'] = totalTime
+            result['peakRSSKB'] = max(result.get('peakRSSKB', 0), maxRSS)
+            result.update(ReadStats(workDir))
+        finally:
+            shutil.rmtree(workDir, ignore_errors=True)
+    return result
+
+
+def CollectKernels(corpus, platforms):
+    kernels = []
+    for platformDir in sorted(glob.glob(os.path.join(corpus, '*'))):
+        if not os.path.isdir(platformDir):
+            continue
+        platform = os.path.basename(platformDir)
+        if platforms and platform not in platforms:
+            continue
+        for ext in ('*.isa', '*.visaasm'):
+            for kernel in sorted(glob.glob(os.path.join(platformDir, ext))):
+                kernels.append((platform, kernel))
+    return kernels
+
+
+def Compare(results, baseline, thresholds):
+    regressions = []
+    for key, result in sorted(results.items()):
+        base = baseline.get(key)
+        if base is None or base.get('status') != 'ok':
+            continue
+        if result.get('status') != 'ok':
+            regressions.append('{0}: {1}'.format(key, result['status']))
+            continue
+        for metric, threshold in thresholds.items():
+            if metric not in result or metric not in base:
+                continue
+            old, new = base[metric], result[metric]
+            if metric == 'totalTime' and new - old < MIN_TIME_DELTA:
+                continue
+            if new <= old:
+                continue
+            delta = 100.0 if old == 0 else (new - old) * 100.0 / old
+            if delta > threshold:
+                regressions.append('{0}: {1} {2} -> {3} (+{4:.2f}%)'.format(
+                    key, metric, old, new, delta))
+    return regressions
+
+
+def ParseThresholds(values):
+    thresholds = dict(DEFAULT_THRESHOLDS)
+    for value in values:
+        metric, sep, percent = value.partition('=')
+        if not sep or metric not in thresholds:
+            raise argparse.ArgumentTypeError(
+                'invalid threshold "{0}", expected one of {1}'.format(
+                    value, ', '.join(sorted(thresholds))))
+        thresholds[metric] = float(percent)
+    return thresholds
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Benchmark compile time and code quality of the vISA '
+                    'finalizer over a kernel corpus.')
+    parser.add_argument('--finalizer', required=True,
+                        help='path to GenX_IR executable')
+    parser.add_argument('--corpus', required=True,
+                        help='directory with one sub-directory per platform')
+    parser.add_argument('--output', required=True,
+                        help='JSON file to write results to')
+    parser.add_argument('--baseline',
+                        help='JSON results of an earlier run to compare with')
+    parser.add_argument('--platform', action='append', default=[],
+                        help='only run given platform(s)')
+    parser.add_argument('--threshold', action='append', default=[],
+                        metavar='METRIC=PERCENT',
+                        help='allowed regression per metric, default: ' +
+                        ', '.join('{0}={1}'.format(k, v) for k, v in
+                                  sorted(DEFAULT_THRESHOLDS.items())))
+    parser.add_argument('--repeat', type=int, default=3,
+                        help='runs per kernel, fastest time is kept')
+    parser.add_argument('--visa-option', action='append', default=[],
+                        help='extra option passed to GenX_IR')
+    args = parser.parse_args()
+
+    try:
+        thresholds = ParseThresholds(args.threshold)
+    except argparse.ArgumentTypeError as e:
+        parser.error(str(e))
+
+    kernels = CollectKernels(args.corpus, args.platform)
+    if not kernels:
+        sys.stderr.write('no kernels found in {0}\n'.format(args.corpus))
+        return 1
+
+    results = {}
+    for platform, kernel in kernels:
+        key = '{0}/{1}'.format(platform, os.path.basename(kernel))
+        results[key] = BenchmarkKernel(args.finalizer, kernel, platform,
+                                       args.visa_option, max(1, args.repeat))
+        sys.stdout.write('{0}: {1}\n'.format(key, results[key]['status']))
+
+    with open(args.output, 'w') as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+
+    failed = [k for k, v in results.items() if v['status'] != 'ok']
+    if failed:
+        sys.stderr.write('{0} kernel(s) failed to compile\n'.format(len(failed)))
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = Compare(results, baseline, thresholds)
+        for regression in regressions:
+            sys.stderr.write('regression: {0}\n'.format(regression))
+        if regressions:
+            return 1
+
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -64,6 +64,12 @@ public:
 
   uint32_t maxGRFPressure = 0;
 
+  // Peak memory in KB held by vISA arenas and the interference matrix during
+  // the Compile() call that produced this kernel, up to the end of its
+  // compilation. Used by IGC to stay within the memory budget
+  // (vISA_MemBudgetMB).
+  uint32_t peakMemoryKB = 0;
+
   // These fields are currently used by IGC.
   // The first two are unweighted (i.e., just a sum of each basic block's
   // estimated cycles), while the last two are weighted by loop (16 iterations
@@ -138,6 +144,13 @@ struct PERF_STATS_VERBOSE {
   uint32_t normIntfNum = 0;
   //Augmentation interference edge #
   uint32_t augIntfNum = 0;
+
+  // Cold blocks moved to the end of the kernel by block layout
+  uint32_t numColdBBsSunk = 0;
+  // Instructions laid out within innermost loops, before and after block
+  // layout
+  uint32_t loopFetchSpanBefore = 0;
+  uint32_t loopFetchSpanAfter = 0;
 public:
   llvm::json::Value toJSON();
 };
@@ -141,6 +141,8 @@ DEF_VISA_OPTION(vISA_hasDoubleAcc, ET_BOOL, "-hasDoubleAcc", UNUSED, false)
 DEF_VISA_OPTION(vISA_finiteMathOnly, ET_BOOL, "-finiteMathOnly",
                 "If set, float operands do not have NaN/Inf", false)
 DEF_VISA_OPTION(vISA_ifCvt, ET_BOOL, "-noifcvt", UNUSED, true)
+// Changes the final block order, a kernel may end with a jmpi instead of EOT.
+DEF_VISA_OPTION(vISA_SinkColdBlocks, ET_BOOL, "-sinkcoldbb", UNUSED, false)
 DEF_VISA_OPTION(vISA_RegSharingHeuristics, ET_BOOL, "-regSharingHeuristics",
                 UNUSED, false)
 DEF_VISA_OPTION(vISA_LVN, ET_BOOL, "-nolvn", UNUSED, true)
@@ -252,10 +254,13 @@ DEF_VISA_OPTION(vISA_LocalDeclareSplitInGlobalRA, ET_BOOL, "-noLocalSplit",
                 UNUSED, true)
 DEF_VISA_OPTION(vISA_DisableSpillCoalescing, ET_BOOL, "-nospillcleanup", UNUSED,
                 false)
+DEF_VISA_OPTION(vISA_HoistLoopFills, ET_BOOL, "-nohoistloopfills", UNUSED,
+                true)
 DEF_VISA_OPTION(vISA_GlobalSendVarSplit, ET_BOOL, "-globalSendVarSplit", UNUSED,
                 false)
 DEF_VISA_OPTION(vISA_NoRemat, ET_BOOL, "-noremat", UNUSED, false)
 DEF_VISA_OPTION(vISA_ForceRemat, ET_BOOL, "-forceremat", UNUSED, false)
+DEF_VISA_OPTION(vISA_RematAllIters, ET_BOOL, "-rematAllIters", UNUSED, false)
 DEF_VISA_OPTION(vISA_SpillMemOffset, ET_INT32, "-spilloffset",
                 "USAGE: -spilloffset <offset>\n", 0)
 DEF_VISA_OPTION(vISA_ReservedGRFNum, ET_INT32, "-reservedGRFNum",
@@ -274,6 +279,8 @@ DEF_VISA_OPTION(vISA_LraFFWindowSize, ET_INT32, "-lraFFWindowSize", UNUSED, 12)
 DEF_VISA_OPTION(vISA_SplitGRFAlignedScalar, ET_BOOL, "-nosplitGRFalignedscalar",
                 UNUSED, true)
 DEF_VISA_OPTION(vISA_DoSplitOnSpill, ET_BOOL, "-nosplitonspill", UNUSED, true)
+DEF_VISA_OPTION(vISA_SplitLiveThroughLoops, ET_BOOL, "-splitlivethrough",
+                UNUSED, false)
 DEF_VISA_OPTION(vISA_IncSpillCostAllAddrTaken, ET_BOOL, "-allowaddrtakenspill",
                 UNUSED, false)
 DEF_VISA_OPTION(vISA_NewSpillCostFunction, ET_BOOL, "-newspillcost", UNUSED,
@@ -300,6 +307,10 @@ DEF_VISA_OPTION(vISA_DumpLiveRanges, ET_BOOL, "-dumplrs", UNUSED, false)
 DEF_VISA_OPTION(vISA_FailSafeRALimit, ET_INT32, "-failSafeRALimit", UNUSED, 3)
 DEF_VISA_OPTION(vISA_DenseMatrixLimit, ET_INT32, "-denseMatrixLimit", UNUSED,
                 0x80000)
+DEF_VISA_OPTION(vISA_MemBudgetMB, ET_INT32, "-memBudgetMB",
+                "USAGE: -memBudgetMB <MB>\n", 0)
+DEF_VISA_OPTION(vISA_BlockProfile, ET_CSTR, "-blockProfile",
+                "USAGE: -blockProfile <file>\n", NULL)
 DEF_VISA_OPTION(vISA_FillConstOpt, ET_BOOL, "-nofillconstopt", UNUSED, true)
 DEF_VISA_OPTION(vISA_GCRRInFF, ET_BOOL, "-GCRRinFF", UNUSED, false)
 
@@ -448,6 +459,10 @@ DEF_VISA_OPTION(vISA_ExtraIntfFile, ET_CSTR, "-extraIntfFile",
 DEF_VISA_OPTION(vISA_AddExtraIntfInfo, ET_BOOL, NULLSTR, UNUSED, false)
 DEF_VISA_OPTION(vISA_OutputvISABinaryName, ET_CSTR, "-outputCisaBinaryName",
                 UNUSED, NULL)
+// Only build the functions of a vISA binary that its kernels call or take
+// the address of.
+DEF_VISA_OPTION(vISA_SkipUnreferencedFuncs, ET_BOOL, "-skipUnreferencedFuncs",
+                UNUSED, false)
 DEF_VISA_OPTION(vISA_LabelStr, ET_CSTR, "-uniqueLabels",
                 "Label String is not provided for the -uniqueLabels option.",
                 NULL)
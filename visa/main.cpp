@@ -24,6 +24,7 @@ SPDX-License-Identifier: MIT
 
 
 #include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/Path.h>
 
 ///
@@ -47,27 +48,14 @@ int parseText(llvm::StringRef fileName, int argc, const char *argv[],
 #ifndef DLL_MODE
 int parseBinary(std::string fileName, int argc, const char *argv[],
                 Options &opt) {
-  vISA::Mem_Manager mem(4096);
-
-  /// Try opening the file.
-  FILE *isafile = fopen(fileName.c_str(), "rb");
-  if (!isafile) {
+  /// Map the file instead of copying it; only the parts of it that are
+  /// decoded are ever paged in.
+  auto isaFile = llvm::MemoryBuffer::getFile(fileName);
+  if (!isaFile) {
     std::cerr << fileName << ": cannot open file\n";
     return EXIT_FAILURE;
   }
-
-  /// Calculate file size.
-  fseek(isafile, 0, SEEK_END);
-  long isafilesize = ftell(isafile);
-  rewind(isafile);
-
-  /// Reading file into buffer.
-  char *isafilebuf = (char *)mem.alloc(isafilesize);
-  if (isafilesize != fread(isafilebuf, 1, isafilesize, isafile)) {
-    std::cerr << fileName << ": Unable to read entire file into buffer.\n";
-    return EXIT_FAILURE;
-  }
-  fclose(isafile);
+  const char *isafilebuf = (*isaFile)->getBufferStart();
 
   TARGET_PLATFORM platform =
       static_cast<TARGET_PLATFORM>(opt.getuInt32Option(vISA_PlatformSet));